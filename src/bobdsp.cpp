@@ -44,9 +44,11 @@
 #include "util/timeutils.h"
 #include "util/JSON.h"
 #include "util/ssedefs.h"
+#include "util/rtcheck.h"
 
 #define CONNECTINTERVAL   1000000
 #define PORTCHECKINTERVAL  100000
+#define GOVERNORINTERVAL   100000
 #define TIMEOUT_INFINITE    -1000
 
 using namespace std;
@@ -273,6 +275,17 @@ void CBobDSP::Process()
     else
       timeout = TIMEOUT_INFINITE; //nothing to retry
 
+    //check the dsp load regularly when there are clients that may be bypassed
+    if (m_clientsmanager.Govern() && (timeout == TIMEOUT_INFINITE || timeout > GOVERNORINTERVAL))
+      timeout = GOVERNORINTERVAL;
+
+#ifdef RTCHECK
+    //log realtime violations from the jack threads
+    RTCheckReport();
+    if (timeout == TIMEOUT_INFINITE || timeout > RTCHECKINTERVAL)
+      timeout = RTCHECKINTERVAL;
+#endif
+
     //process messages, blocks if there's nothing to do
     ProcessMessages(timeout);
 
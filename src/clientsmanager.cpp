@@ -32,6 +32,16 @@ using namespace std;
 
 #define SETTINGSFILE ".bobdsp/clients.json"
 
+//when the jack dsp load goes over GOVERNOR_HIGHLOAD, expendable clients are bypassed one at a time,
+//with at least GOVERNOR_SETTLETIME in between, so that the dsp load can drop
+//when the dsp load has been under GOVERNOR_LOWLOAD for GOVERNOR_HOLDTIME, bypassed clients are enabled again
+//one at a time, but only when the load they had before being bypassed will fit under GOVERNOR_RESTORELOAD
+#define GOVERNOR_HIGHLOAD    85.0f
+#define GOVERNOR_LOWLOAD     60.0f
+#define GOVERNOR_RESTORELOAD 75.0f
+#define GOVERNOR_SETTLETIME  500000
+#define GOVERNOR_HOLDTIME    2000000
+
 CClientsManager::CClientsManager(CBobDSP& bobdsp):
   CMessagePump("clientsmanager"),
   CJSONSettings(SETTINGSFILE, "client", m_condition),
@@ -42,6 +52,8 @@ CClientsManager::CClientsManager(CBobDSP& bobdsp):
   m_clientindex = 0;
   m_controlindex = 0;
   m_fileindex = -1;
+  m_lastbypass = 0;
+  m_lowloadstart = -1;
 }
 
 CClientsManager::~CClientsManager()
@@ -228,6 +240,10 @@ void CClientsManager::AddClient(JSONMap& client, const std::string& name, const
       return; //gain invalid
   }
 
+  int64_t priority = 0;
+  if (LoadInt64(client, priority, "priority", source) == INVALID)
+    return;
+
   CLadspaPlugin* ladspaplugin = LoadPlugin(source, client);
   if (ladspaplugin == NULL)
     return; //plugin not set, not found or invalid
@@ -241,14 +257,15 @@ void CClientsManager::AddClient(JSONMap& client, const std::string& name, const
   //everything ok, allocate a new client
   CJackLadspa* jackclient = new CJackLadspa(ladspaplugin, name, instances,
                                             gain, controlvalues);
+  jackclient->SetPriority(priority);
   m_clients.push_back(jackclient);
   m_checkclients = true;
 
   m_clientindex++;
   m_condition.Broadcast();
 
-  Log("Added client \"%s\" instances:%" PRIi64 " pregain:%.3f postgain:%.3f",
-      name.c_str(), instances, gain[0], gain[1]);
+  Log("Added client \"%s\" instances:%" PRIi64 " pregain:%.3f postgain:%.3f priority:%" PRIi64,
+      name.c_str(), instances, gain[0], gain[1], priority);
 }
 
 void CClientsManager::DeleteClient(JSONMap& client, const std::string& name, const std::string& source)
@@ -310,6 +327,13 @@ void CClientsManager::UpdateClient(JSONMap& client, const std::string& name, con
       return;
   }
 
+  int64_t priority;
+  state = LoadInt64(client, priority, "priority", source);
+  if (state == INVALID)
+    return;
+
+  bool priorityupdated = state == SUCCESS;
+
   controlmap controlvalues;
   if (!LoadControls(source, client, controlvalues))
     return; //invalid control values
@@ -339,6 +363,21 @@ void CClientsManager::UpdateClient(JSONMap& client, const std::string& name, con
     }
   }
 
+  if (priorityupdated && priority != jackclient->Priority())
+  {
+    Log("Client \"%s\" setting priority to %" PRIi64, name.c_str(), priority);
+    jackclient->SetPriority(priority);
+
+    //a client that's not expendable anymore can't stay bypassed
+    if (!jackclient->IsExpendable() && jackclient->IsBypassed())
+    {
+      Log("Enabling client \"%s\" again", name.c_str());
+      jackclient->SetBypass(false);
+    }
+
+    controlupdated = true;
+  }
+
   //update control values
   if (!controlvalues.empty())
   {
@@ -647,6 +686,14 @@ CJSONGenerator* CClientsManager::ClientsToJSON(bool tofile)
     generator->AddDouble((*it)->GetGain(0));
     generator->AddString("postgain");
     generator->AddDouble((*it)->GetGain(1));
+    generator->AddString("priority");
+    generator->AddInt((*it)->Priority());
+
+    if (!tofile)
+    {
+      generator->AddString("bypassed");
+      generator->AddBool((*it)->IsBypassed());
+    }
 
     generator->AddString("controls");
     generator->ArrayOpen();
@@ -702,6 +749,47 @@ CJSONGenerator* CClientsManager::ClientsToJSON(bool tofile)
   return generator;
 }
 
+//the values of the control outputs of every client that has them, in tenths, as integers
+//this is polled often by meters in the web ui, so it has no names or port descriptions,
+//the values are in the order of the plugin's control output ports, for each instance after the other
+CJSONGenerator* CClientsManager::ControlOutputsToJSON()
+{
+  CJSONGenerator* generator = new CJSONGenerator(false);
+
+  generator->MapOpen();
+  generator->AddString("clients");
+  generator->ArrayOpen();
+
+  CLock lock(m_condition);
+
+  vector<float> values;
+  for (vector<CJackLadspa*>::iterator it = m_clients.begin(); it != m_clients.end(); it++)
+  {
+    if ((*it)->NeedsDelete())
+      continue;
+
+    values.clear();
+    (*it)->GetControlOutputs(values);
+    if (values.empty())
+      continue;
+
+    generator->MapOpen();
+    generator->AddString("name");
+    generator->AddString((*it)->Name());
+    generator->AddString("values");
+    generator->ArrayOpen();
+    for (vector<float>::iterator value = values.begin(); value != values.end(); value++)
+      generator->AddInt(Round64(*value * 10.0));
+    generator->ArrayClose();
+    generator->MapClose();
+  }
+
+  generator->ArrayClose();
+  generator->MapClose();
+
+  return generator;
+}
+
 void CClientsManager::Process(bool& triedconnect, bool& allconnected, bool tryconnect)
 {
   CLock lock(m_condition);
@@ -764,6 +852,102 @@ void CClientsManager::Process(bool& triedconnect, bool& allconnected, bool tryco
   }
 }
 
+//bypasses expendable clients when the jack dsp load is too high, and enables them again when it's low enough
+//returns true when there are expendable clients, then this needs to be called regularly
+bool CClientsManager::Govern()
+{
+  CLock lock(m_condition);
+
+  float        load = -1.0f;
+  bool         hasexpendable = false;
+  CJackLadspa* bypass = NULL;  //the client to bypass when the load is high
+  CJackLadspa* restore = NULL; //the client to enable when the load is low
+  for (vector<CJackLadspa*>::iterator it = m_clients.begin(); it != m_clients.end(); it++)
+  {
+    if (!(*it)->IsConnected() || (*it)->NeedsDelete())
+      continue;
+
+    //the dsp load doesn't mean anything when jackd is rendering offline
+    if ((*it)->IsFreewheeling())
+    {
+      m_lowloadstart = -1;
+      return true;
+    }
+
+    //every client is connected to the same jackd, so the load can be read from any of them
+    if (load < 0.0f)
+      load = (*it)->CpuLoad();
+
+    if (!(*it)->IsExpendable())
+      continue;
+
+    hasexpendable = true;
+
+    //bypass the client with the lowest priority first, if there's more than one, bypass the heaviest one
+    //enable the bypassed client with the highest priority first
+    if (!(*it)->IsBypassed())
+    {
+      if (!bypass || (*it)->Priority() < bypass->Priority() ||
+          ((*it)->Priority() == bypass->Priority() && (*it)->DspLoad() > bypass->DspLoad()))
+        bypass = *it;
+    }
+    else
+    {
+      if (!restore || (*it)->Priority() > restore->Priority())
+        restore = *it;
+    }
+  }
+
+  if (!hasexpendable)
+  {
+    m_lowloadstart = -1;
+    return false;
+  }
+
+  int64_t now = GetTimeUs();
+  bool    changed = false;
+
+  if (load > GOVERNOR_HIGHLOAD)
+  {
+    m_lowloadstart = -1;
+    if (bypass && now - m_lastbypass >= GOVERNOR_SETTLETIME)
+    {
+      Log("Dsp load %.1f%%, bypassing client \"%s\"", load, bypass->Name().c_str());
+      bypass->SetBypass(true);
+      m_lastbypass = now;
+      changed = true;
+    }
+  }
+  else if (load < GOVERNOR_LOWLOAD && restore)
+  {
+    if (m_lowloadstart == -1)
+    {
+      m_lowloadstart = now;
+    }
+    else if (now - m_lowloadstart >= GOVERNOR_HOLDTIME &&
+             load + restore->DspLoad() * 100.0f < GOVERNOR_RESTORELOAD)
+    {
+      Log("Dsp load %.1f%%, enabling client \"%s\" again", load, restore->Name().c_str());
+      restore->SetBypass(false);
+      m_lowloadstart = now; //wait for the hold time again before enabling the next one
+      changed = true;
+    }
+  }
+  else
+  {
+    m_lowloadstart = -1;
+  }
+
+  //let anyone waiting for changes know that the bypass state changed
+  if (changed)
+  {
+    m_controlindex++;
+    m_condition.Broadcast();
+  }
+
+  return true;
+}
+
 int CClientsManager::ClientPipes(pollfd*& fds, int extra)
 {
   CLock lock(m_condition);
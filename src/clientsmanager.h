@@ -42,10 +42,12 @@ class CClientsManager : public CMessagePump, public CJSONSettings
 
     void            Stop();
     void            Process(bool& triedconnect, bool& allconnected, bool tryconnect);
+    bool            Govern();
     int             ClientPipes(pollfd*& fds, int extra);
     void            ProcessMessages();
 
     CJSONGenerator* ClientsToJSON(bool tofile);
+    CJSONGenerator* ControlOutputsToJSON();
 
   private:
     CBobDSP&                  m_bobdsp;
@@ -56,6 +58,8 @@ class CClientsManager : public CMessagePump, public CJSONSettings
     int64_t                   m_clientindex;  //changed whenever a client is added or deleted
     int64_t                   m_controlindex; //changed whenever a control is changed
     int64_t                   m_fileindex;    //set to m_clientindex whenever settings are loaded from a file
+    int64_t                   m_lastbypass;   //when the governor last bypassed a client
+    int64_t                   m_lowloadstart; //since when the dsp load has been low, -1 if it's not
 
     enum LOADSTATE
     {
@@ -23,6 +23,7 @@
 #include "util/misc.h"
 #include "util/lock.h"
 #include "util/thread.h"
+#include "util/rtcheck.h"
 
 #ifndef _GNU_SOURCE
   #define _GNU_SOURCE //for canonicalize_file_name
@@ -261,6 +262,16 @@ MHD_Result CHttpServer::AnswerToConnection(void *cls, struct MHD_Connection *con
     {
       return CreateJSONDownload(connection, httpserver->m_bobdsp.ClientsManager().ClientsToJSON(false));
     }
+    else if (strurl == "/controloutputs")
+    {
+      return CreateJSONDownload(connection, httpserver->m_bobdsp.ClientsManager().ControlOutputsToJSON());
+    }
+#ifdef RTCHECK
+    else if (strurl == "/rtcheck")
+    {
+      return CreateJSONDownload(connection, RTCheckToJSON());
+    }
+#endif
     else
     {
       return CreateFileDownload(connection, strurl, httpserver->m_htmldir.c_str());
@@ -20,6 +20,7 @@
 #include "util/misc.h"
 #include "util/log.h"
 #include "util/thread.h"
+#include "util/rtcheck.h"
 #include <cassert>
 
 #include "jackclient.h"
@@ -33,6 +34,7 @@ CJackClient::CJackClient(const std::string& name, const std::string& logname,
   CMessagePump(sender)
 {
   m_clienttype   = None;
+  m_freewheel    = false;
   m_name         = name;
   m_logname      = logname;
   m_threadname   = threadname;
@@ -82,6 +84,7 @@ bool CJackClient::ConnectInternal()
 
   //this is set in PJackInfoShutdownCallback(), init to 0 here so we know when the jack thread has exited
   m_exitstatus = (jack_status_t)0; 
+  m_freewheel = false;
   m_exitreason.clear();
 
   //let the derived class set some things up
@@ -135,6 +138,13 @@ bool CJackClient::ConnectInternal()
       LogError("%s error %i setting samplerate callback: \"%s\"",
                Capitalize(m_logname).c_str(), returnv, GetErrno().c_str());
 
+    //the freewheel callback is called when jackd enters or leaves freewheel mode,
+    //in that case audio is rendered offline as fast as possible
+    returnv = jack_set_freewheel_callback(m_client, SJackFreewheelCallback, this);
+    if (returnv != 0)
+      LogError("%s error %i setting freewheel callback: \"%s\"",
+               Capitalize(m_logname).c_str(), returnv, GetErrno().c_str());
+
     //SJackProcessCallback gets called when jack has new audio data to process
     returnv = jack_set_process_callback(m_client, SJackProcessCallback, this);
     if (returnv != 0)
@@ -243,11 +253,31 @@ void CJackClient::PJackThreadInitCallback()
 {
   //set the name of the jack thread
   CThread::SetCurrentThreadName(m_threadname);
+
+  RTCheckSetThreadName(m_threadname.c_str());
+}
+
+//the process and buffer size callbacks of an audio processor run in realtime, unless jackd is freewheeling,
+//only the time spent in them is checked, not the time libjack spends waiting for the next cycle
+bool CJackClient::InRealtime()
+{
+  return m_clienttype == AudioProcessor && !m_freewheel;
 }
 
 int CJackClient::SJackProcessCallback(jack_nframes_t nframes, void *arg)
 {
-  return ((CJackClient*)arg)->PJackProcessCallback(nframes);
+  CJackClient* client   = (CJackClient*)arg;
+  bool         realtime = client->InRealtime();
+
+  if (realtime)
+    RTCheckEnter();
+
+  int returnv = client->PJackProcessCallback(nframes);
+
+  if (realtime)
+    RTCheckLeave();
+
+  return returnv;
 }
 
 int CJackClient::PJackProcessCallback(jack_nframes_t nframes)
@@ -303,7 +333,18 @@ int CJackClient::PJackSamplerateCallback(jack_nframes_t nframes)
 
 int CJackClient::SJackBufferSizeCallback(jack_nframes_t nframes, void *arg)
 {
-  return ((CJackClient*)arg)->PJackBufferSizeCallback(nframes);
+  CJackClient* client   = (CJackClient*)arg;
+  bool         realtime = client->InRealtime();
+
+  if (realtime)
+    RTCheckEnter();
+
+  int returnv = client->PJackBufferSizeCallback(nframes);
+
+  if (realtime)
+    RTCheckLeave();
+
+  return returnv;
 }
 
 int CJackClient::PJackBufferSizeCallback(jack_nframes_t nframes)
@@ -312,3 +353,14 @@ int CJackClient::PJackBufferSizeCallback(jack_nframes_t nframes)
   return 0;
 }
 
+
+void CJackClient::SJackFreewheelCallback(int starting, void *arg)
+{
+  ((CJackClient*)arg)->PJackFreewheelCallback(starting);
+}
+
+void CJackClient::PJackFreewheelCallback(int starting)
+{
+  //read from the process callback
+  m_freewheel = starting != 0;
+}
@@ -43,6 +43,9 @@ class CJackClient : public CMessagePump
     const std::string& Name()       { return m_name;          }
     const std::string& LogName()    { return m_logname;       }
 
+    float CpuLoad() { return m_client ? jack_cpu_load(m_client) : 0.0f; }
+    bool  IsFreewheeling() { return m_freewheel; }
+
   protected:
     enum
     {
@@ -55,6 +58,7 @@ class CJackClient : public CMessagePump
     bool           m_connected;
     bool           m_wasconnected;
     jack_client_t* m_client;
+    volatile bool  m_freewheel;
     std::string    m_name;
     std::string    m_logname;
     std::string    m_threadname;
@@ -74,6 +78,8 @@ class CJackClient : public CMessagePump
     virtual bool PostActivate() { return true; };
     virtual void PostDeactivate() {};
 
+    bool         InRealtime();
+
     static  void SJackThreadInitCallback(void *arg);
     void         PJackThreadInitCallback();
 
@@ -94,6 +100,9 @@ class CJackClient : public CMessagePump
 
     static  int  SJackBufferSizeCallback(jack_nframes_t nframes, void *arg);
     virtual int  PJackBufferSizeCallback(jack_nframes_t nframes);
+
+    static  void SJackFreewheelCallback(int starting, void *arg);
+    virtual void PJackFreewheelCallback(int starting);
 };
 
 #endif //JACKCLIENT_H
@@ -22,10 +22,15 @@
 #include "util/inclstdint.h"
 #include "util/misc.h"
 #include "util/lock.h"
+#include "util/timeutils.h"
 #include "jackladspa.h"
 
 using namespace std;
 
+//the longest internal block of the plugins is the 8192 sample block of the slowest convolver level,
+//its first result is used one block after its worker thread starts on it, so warm up for two blocks
+#define WARMUPSAMPLES 16384
+
 CJackLadspa::CJackLadspa(CLadspaPlugin* plugin, const std::string& name, int nrinstances,
                          double* gain, controlmap controlinputs):
   CJackClient(name, string("client \"") + name + "\"", name)
@@ -36,6 +41,9 @@ CJackLadspa::CJackLadspa(CLadspaPlugin* plugin, const std::string& name, int nri
   m_controlinputs = controlinputs;
   m_delete        = false;
   m_restart       = false;
+  m_priority      = 0;
+  m_bypass        = false;
+  m_dspload       = 0.0f;
   m_samplerate    = 0;
   m_buffersize    = 0;
 
@@ -75,6 +83,14 @@ void CJackLadspa::PreConnect()
   //load all symbols, so it doesn't have to be done from the jack thread
   //this is better for realtime performance
   m_plugin->LoadAllSymbols();
+
+  //when the plugin smooths its controls itself, pass new values to it directly,
+  //then the jack thread doesn't have to run it on small blocks while a control changes
+  if (m_plugin->SmoothsControls())
+  {
+    for (controlmap::iterator it = m_controlinputs.begin(); it != m_controlinputs.end(); it++)
+      it->second.SetSmooth(false);
+  }
 }
 
 bool CJackLadspa::PreActivate()
@@ -94,6 +110,10 @@ bool CJackLadspa::PreActivate()
       return false;
   }
 
+  //run each instance on silence, so that its first periods in the jack thread are not slowed down
+  for (vector<CLadspaInstance*>::iterator it = m_instances.begin(); it != m_instances.end(); it++)
+    (*it)->WarmUp(WARMUPSAMPLES);
+
   return true;
 }
 
@@ -132,6 +152,13 @@ void CJackLadspa::UpdateControls(controlmap& controlinputs)
     m_newcontrolinputs[it->first] = it->second;
 }
 
+void CJackLadspa::GetControlOutputs(std::vector<float>& values)
+{
+  //the control outputs of all instances, one after the other
+  for (vector<CLadspaInstance*>::iterator it = m_instances.begin(); it != m_instances.end(); it++)
+    (*it)->GetControlOutputs(values);
+}
+
 void CJackLadspa::TransferNewControlInputs(controlmap& controlinputs)
 {
   for (controlmap::iterator it = m_newcontrolinputs.begin();
@@ -160,12 +187,22 @@ bool CJackLadspa::NeedsSmooth()
   return false;
 }
 
-#define SMOOTHBLOCK 0.001f
-#define SMOOTHTIME  0.05f
+#define SMOOTHBLOCK   0.001f
+#define SMOOTHTIME    0.05f
+#define DSPLOADSMOOTH 0.1f
 int CJackLadspa::PJackProcessCallback(jack_nframes_t nframes)
 {
+  //when freewheeling, jackd renders offline and doesn't need realtime guarantees,
+  //so wait for the lock instead of possibly missing control updates
+  bool freewheel = m_freewheel;
+
+  //measure how long processing takes, the clients manager uses this
+  //to decide which clients to bypass when the dsp load is too high
+  bool    bypass = m_bypass;
+  int64_t start  = freewheel ? 0 : GetTimeUs();
+
   //check if gain was updated, use a trylock to prevent blocking the realtime jack thread
-  CLock lock(m_mutex, true);
+  CLock lock(m_mutex, !freewheel);
   if (lock.HasLock())
   {
     //update the gain, but only when it changed, otherwise m_floatorig
@@ -183,32 +220,47 @@ int CJackLadspa::PJackProcessCallback(jack_nframes_t nframes)
     lock.Leave();
   }
 
-  //chose a blocksize that is one millisecond of samples, then round up
-  //to the nearest multiple of 4
-  int blocksize = Max(Round32(SMOOTHBLOCK * m_samplerate), 4);
-  if ((blocksize & 3) != 0)
-    blocksize = (blocksize & ~3) + 4;
+  //the bypass is faded in and out by each instance,
+  //the jack buffers are looked up once here, the blocks below use offsets into them
+  for (vector<CLadspaInstance*>::iterator it = m_instances.begin(); it != m_instances.end(); it++)
+  {
+    (*it)->SetBypass(bypass);
+    (*it)->SetFreewheel(freewheel);
+    (*it)->GetJackBuffers(nframes);
+  }
 
-  //process audio in small blocks with control smoothing when necessary
   int processed = 0;
-  while (NeedsSmooth() && processed < (int)nframes)
+
+  //when freewheeling, controls are applied immediately, since smoothing them
+  //in small blocks is only useful for listening in realtime
+  if (!freewheel)
   {
-    int   process = Min((int)nframes - processed, blocksize);
-    float smoothval = ((float)process / SMOOTHTIME) / m_samplerate;
+    //chose a blocksize that is one millisecond of samples, then round up
+    //to the nearest multiple of 4
+    int blocksize = Max(Round32(SMOOTHBLOCK * m_samplerate), 4);
+    if ((blocksize & 3) != 0)
+      blocksize = (blocksize & ~3) + 4;
+
+    //process audio in small blocks with control smoothing when necessary
+    while (NeedsSmooth() && processed < (int)nframes)
+    {
+      int   process = Min((int)nframes - processed, blocksize);
+      float smoothval = ((float)process / SMOOTHTIME) / m_samplerate;
 
-    //move each gain value towards its target
-    for (int i = 0; i < 2; i++)
-      m_runninggain[i].Update(smoothval);
+      //move each gain value towards its target
+      for (int i = 0; i < 2; i++)
+        m_runninggain[i].Update(smoothval);
 
-    //move each control value towards its target
-    for (controlmap::iterator it = m_controlinputs.begin(); it != m_controlinputs.end(); it++)
-      it->second.Update(smoothval);
+      //move each control value towards its target
+      for (controlmap::iterator it = m_controlinputs.begin(); it != m_controlinputs.end(); it++)
+        it->second.Update(smoothval);
 
-    //process a small block of audio
-    for (vector<CLadspaInstance*>::iterator it = m_instances.begin(); it != m_instances.end(); it++)
-      (*it)->Run(nframes, process, processed, m_runninggain[0].FloatVal(), m_runninggain[1].FloatVal());
+      //process a small block of audio
+      for (vector<CLadspaInstance*>::iterator it = m_instances.begin(); it != m_instances.end(); it++)
+        (*it)->Run(process, processed, m_runninggain[0].FloatVal(), m_runninggain[1].FloatVal());
 
-    processed += process;
+      processed += process;
+    }
   }
 
   //process remaining audio without smoothing the controls
@@ -224,7 +276,15 @@ int CJackLadspa::PJackProcessCallback(jack_nframes_t nframes)
 
     //process the remaining audio
     for (vector<CLadspaInstance*>::iterator it = m_instances.begin(); it != m_instances.end(); it++)
-      (*it)->Run(nframes, nframes - processed, processed, m_runninggain[0].FloatVal(), m_runninggain[1].FloatVal());
+      (*it)->Run(nframes - processed, processed, m_runninggain[0].FloatVal(), m_runninggain[1].FloatVal());
+  }
+
+  //keep the load of the last time this client wasn't bypassed
+  //so the clients manager can tell if there's room to enable it again
+  if (!freewheel && !bypass && m_samplerate > 0)
+  {
+    float load = (float)(GetTimeUs() - start) * m_samplerate / (nframes * 1000000.0f);
+    m_dspload += (load - m_dspload) * DSPLOADSMOOTH;
   }
 
   return 0;
@@ -42,18 +42,29 @@ class CJackLadspa : public CJackClient
     int  NrInstances()                   { return m_nrinstances;        }
     void SetNrInstances(int nrinstances) { m_nrinstances = nrinstances; }
 
+    int   Priority()                     { return m_priority;           }
+    void  SetPriority(int priority)      { m_priority = priority;       }
+    bool  IsExpendable()                 { return m_priority < 0;       }
+    void  SetBypass(bool bypass)         { m_bypass = bypass;           }
+    bool  IsBypassed()                   { return m_bypass;             }
+    float DspLoad()                      { return m_dspload;            }
+
     CLadspaPlugin*     Plugin()           { return m_plugin;        }
     double             GetGain(int index) { return m_gain[index];   }
     void               UpdateGain(double gain, int index);
     int                Samplerate()       { return m_samplerate;    }
     void               GetControlInputs(controlmap& controlinputs);
     void               UpdateControls(controlmap& controlinputs);
+    void               GetControlOutputs(std::vector<float>& values);
 
   private:
     bool           m_delete;
     bool           m_restart;
     CLadspaPlugin* m_plugin;
     int            m_nrinstances;
+    int            m_priority; //clients with a priority lower than 0 may be bypassed when the dsp load is high
+    volatile bool  m_bypass;
+    volatile float m_dspload;  //fraction of the jack period used by this client, when not bypassed
 
     CMutex         m_mutex;
     double         m_gain[2]; //pregain, postgain
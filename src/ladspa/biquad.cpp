@@ -19,6 +19,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include "biquad.h"
+#include "util/misc.h"
 
 using namespace BobDSPLadspa;
 
@@ -30,6 +31,13 @@ CBiquad::CBiquad(EFILTER type, unsigned long samplerate)
   memset(m_ports, 0, sizeof(m_ports));
   m_type = type;
   m_samplerate = samplerate;
+  m_jump       = true;
+  m_rampleft   = 0;
+  memset(m_ramp, 0, sizeof(m_ramp));
+  memset(m_rampstep, 0, sizeof(m_rampstep));
+#ifdef USE_SSE
+  m_matrixvalid = false;
+#endif
 }
 
 CBiquad::~CBiquad()
@@ -42,6 +50,14 @@ void CBiquad::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
 }
 
 void CBiquad::Activate()
+{
+  m_jump     = true;
+  m_rampleft = 0;
+
+  ClearDelays();
+}
+
+void CBiquad::ClearDelays()
 {
 #ifdef USE_SSE
   memset(&m_indelay, 0, sizeof(m_indelay));
@@ -54,35 +70,62 @@ void CBiquad::Activate()
 #endif
 }
 
+bool CBiquad::IsIdentity()
+{
+  //start the ramp to new coefficients here too, otherwise this would return true
+  //for new controls that are an identity before Run() has started ramping to them
+  UpdateCoefs();
+
+  //a linkwitz transform from a response to the same response doesn't change anything
+  //when the coefficients are still moving, the filter needs to run until they're done
+  return m_type == LINKWITZTRANSFORM && *m_ports[2] == *m_ports[4] && *m_ports[3] == *m_ports[5] &&
+         m_rampleft == 0;
+}
+
+void CBiquad::Skipped()
+{
+  //the delayed samples are from before the host started skipping,
+  //when the filter runs again it starts from silence, like after Activate()
+  ClearDelays();
+}
+
+void CBiquad::UpdateCoefs()
+{
+  //this only does the calculation when the controls changed
+  if (m_coefs.Calculate(m_type, m_samplerate, m_ports))
+    StartRamp();
+}
+
 void OPTIMIZE CBiquad::Run(unsigned long samplecount)
 {
   //calculate the coeffients on each run, since they might change
-  m_coefs.Calculate(m_type, m_samplerate, m_ports);
+  UpdateCoefs();
 
   LADSPA_Data* in    = m_ports[0];
   LADSPA_Data* inend = in + samplecount;
   LADSPA_Data* out   = m_ports[1];
 
+  //move the coefficients towards the new values, changing them on every sample
+  //the rest of the block is processed with the new coefficients
+  if (m_rampleft > 0)
+  {
+    float* rampend = in + Min(m_rampleft, (int)samplecount);
+    m_rampleft -= rampend - in;
+    RunRamp(in, rampend, out);
+  }
+
 #ifdef USE_SSE
 
+  //the block kernel needs a new matrix when the coefficients change
+  if (!m_matrixvalid && in != inend)
+    CalculateMatrix();
+
   //load filter coefficients
   __m128 acoeffs  = _mm_set_ps(0.0f, 0.0f, m_coefs.a2, m_coefs.a1);
   __m128 bcoeffs  = _mm_set_ps(0.0f, m_coefs.b2, m_coefs.b1, m_coefs.b0);
-  
-  //run the quad filter if the input pointer can be aligned to 16 bytes after processing 0 or more samples
-  //and there are 4 or more samples to process after getting 16 byte alignment
-  uintptr_t inoffset = (uintptr_t)in & 15;
-  if ((inoffset == 0 && samplecount >= 4) || ((inoffset & 3) == 0 && samplecount >= 8 - inoffset / 4))
-  {
-    //process samples until the input pointer gets 16 byte alignment
-    if (inoffset != 0)
-      RunSingle(in, in + (4 - inoffset / 4), out, acoeffs, bcoeffs);
 
-    //process 4 samples at a time
-    RunQuad(in, in + (samplecount & ~3), out, acoeffs, bcoeffs);
-  }
-
-  //run the single filter on the remaining samples
+  //calculate BIQUAD_BLOCK samples at a time, then run the single filter on the remaining samples
+  RunBlock(in, in + ((inend - in) & ~(BIQUAD_BLOCK - 1)), out);
   RunSingle(in, inend, out, acoeffs, bcoeffs);
 
 #else
@@ -108,6 +151,87 @@ void OPTIMIZE CBiquad::Run(unsigned long samplecount)
 #endif
 }
 
+void CBiquad::StartRamp()
+{
+  float target[COEF_NUM] = { m_coefs.b0, m_coefs.b1, m_coefs.b2, m_coefs.a1, m_coefs.a2 };
+
+  if (m_jump)
+  {
+    //the first coefficients after activating are used directly
+    memcpy(m_ramp, target, sizeof(m_ramp));
+    m_rampleft = 0;
+    m_jump     = false;
+  }
+  else
+  {
+    //a ramp starts from the current coefficients, which are somewhere on the previous ramp
+    m_rampleft = Max(Round32(BIQUAD_RAMPTIME * m_samplerate), 1);
+    for (int i = 0; i < COEF_NUM; i++)
+      m_rampstep[i] = (target[i] - m_ramp[i]) / m_rampleft;
+  }
+
+#ifdef USE_SSE
+  m_matrixvalid = false;
+#endif
+}
+
+void OPTIMIZE CBiquad::RunRamp(float*& in, float* inend, float*& out)
+{
+#ifdef USE_SSE
+  __m128 acoeffs  = _mm_set_ps(0.0f, 0.0f, m_ramp[COEF_A2], m_ramp[COEF_A1]);
+  __m128 bcoeffs  = _mm_set_ps(0.0f, m_ramp[COEF_B2], m_ramp[COEF_B1], m_ramp[COEF_B0]);
+  __m128 astep    = _mm_set_ps(0.0f, 0.0f, m_rampstep[COEF_A2], m_rampstep[COEF_A1]);
+  __m128 bstep    = _mm_set_ps(0.0f, m_rampstep[COEF_B2], m_rampstep[COEF_B1], m_rampstep[COEF_B0]);
+
+  while (in != inend)
+  {
+    acoeffs = _mm_add_ps(acoeffs, astep);
+    bcoeffs = _mm_add_ps(bcoeffs, bstep);
+    RunSingle(in, in + 1, out, acoeffs, bcoeffs);
+  }
+
+  ssevec a, b;
+  a.v = acoeffs;
+  b.v = bcoeffs;
+  m_ramp[COEF_B0] = b.f[0];
+  m_ramp[COEF_B1] = b.f[1];
+  m_ramp[COEF_B2] = b.f[2];
+  m_ramp[COEF_A1] = a.f[0];
+  m_ramp[COEF_A2] = a.f[1];
+#else
+  while (in != inend)
+  {
+    for (int i = 0; i < COEF_NUM; i++)
+      m_ramp[i] += m_rampstep[i];
+
+    *out = *in * m_ramp[COEF_B0] +
+           m_indelay[m_delay1] * m_ramp[COEF_B1] +
+           m_indelay[m_delay2] * m_ramp[COEF_B2] +
+           m_outdelay[m_delay1] * m_ramp[COEF_A1] +
+           m_outdelay[m_delay2] * m_ramp[COEF_A2];
+
+    m_indelay[m_delay2] = *in;
+    m_outdelay[m_delay2] = *out;
+
+    m_delay1 ^= 1;
+    m_delay2 ^= 1;
+
+    in++;
+    out++;
+  }
+#endif
+
+  //at the end of the ramp, use the exact new coefficients
+  if (m_rampleft == 0)
+  {
+    m_ramp[COEF_B0] = m_coefs.b0;
+    m_ramp[COEF_B1] = m_coefs.b1;
+    m_ramp[COEF_B2] = m_coefs.b2;
+    m_ramp[COEF_A1] = m_coefs.a1;
+    m_ramp[COEF_A2] = m_coefs.a2;
+  }
+}
+
 #ifdef USE_SSE
 void INLINE OPTIMIZE CBiquad::RunSingle(float*& in, float* inend, float*& out, __m128 acoeffs, __m128 bcoeffs)
 {
@@ -161,66 +285,152 @@ void INLINE OPTIMIZE CBiquad::RunSingle(float*& in, float* inend, float*& out, _
   }
 }
 
-void INLINE OPTIMIZE CBiquad::RunQuad(float*& in, float* inend, float*& out, __m128 acoeffs, __m128 bcoeffs)
+//calculates the output of BIQUAD_BLOCK samples from the input samples and the delayed samples,
+//this is the same as running the biquad on a single sample at a time, but since every output
+//sample only depends on the input and the delayed samples of the previous block, all multiplies
+//are independent, only the delayed samples are passed from one block to the next
+void CBiquad::CalculateMatrix()
 {
-  //same as RunSingle, but with 4 floats at a time
-  //it loads 4 floats at the same time using packed load
-  //packed store can't be used since the alignment of the output pointer can't be guaranteed to be 16 bytes
-  //for some reason it's also slower than a single store
-  while (in != inend)
+  for (int col = 0; col < BIQUAD_MATRIXCOLS; col++)
   {
-    //do a packed load from a 16 byte aligned pointer
-    __m128 inload = _mm_load_ps(in);
-    in += 4;
-
-    for (int i = 0; i < 4; i++)
+    //x[-2], x[-1], x[0] .. x[BIQUAD_BLOCK - 1], and the same for y
+    double x[BIQUAD_BLOCK + 2] = {};
+    double y[BIQUAD_BLOCK + 2] = {};
+
+    if (col < BIQUAD_BLOCK)
+      x[col + 2] = 1.0;
+    else if (col == BIQUAD_BLOCK)
+      x[1] = 1.0;
+    else if (col == BIQUAD_BLOCK + 1)
+      x[0] = 1.0;
+    else if (col == BIQUAD_BLOCK + 2)
+      y[1] = 1.0;
+    else
+      y[0] = 1.0;
+
+    for (int i = 2; i < BIQUAD_BLOCK + 2; i++)
     {
-      /*unpack with m_indelay so that:
-        inload     0 0 0 i
-        m_indelay: e f g h
-
-        becomes
-
-        invec:     g 0 h i
-      */
-      __m128 invec = _mm_unpacklo_ps(inload, m_indelay);
+      y[i] = x[i] * m_coefs.b0 + x[i - 1] * m_coefs.b1 + x[i - 2] * m_coefs.b2 +
+             y[i - 1] * m_coefs.a1 + y[i - 2] * m_coefs.a2;
+    }
 
-      /*shuffle invec with m_indelay to make:
-        m_indelay: f g h i
-        now the values in m_indelay are shifted one to the left
-        and the new input sample is added to m_indelay
-      */
-      m_indelay = _mm_shuffle_ps(invec, m_indelay, 0x94);
+    for (int i = 0; i < BIQUAD_BLOCK; i++)
+      m_matrix[col][i] = y[i + 2];
+  }
 
-      //multiply the input samples with the b coefficients
-      invec = _mm_mul_ps(m_indelay, bcoeffs);
+  m_matrixvalid = true;
+}
 
-      //multiply the delayed output samples with the a coefficients
-      __m128 outvec = _mm_mul_ps(m_outdelay, acoeffs);
+#ifdef __AVX__
+void INLINE OPTIMIZE CBiquad::RunBlock(float*& in, float* inend, float*& out)
+{
+  if (in == inend)
+    return;
+
+  __m256 col[BIQUAD_MATRIXCOLS];
+  for (int i = 0; i < BIQUAD_MATRIXCOLS; i++)
+    col[i] = _mm256_loadu_ps(m_matrix[i]);
+
+  //m_indelay holds x[n - 1] in the lowest float, x[n - 2] in the next, m_outdelay the same for y
+  __m128 xm1 = _mm_shuffle_ps(m_indelay, m_indelay, 0x00);
+  __m128 xm2 = _mm_shuffle_ps(m_indelay, m_indelay, 0x55);
+  __m128 ym1 = _mm_shuffle_ps(m_outdelay, m_outdelay, 0x00);
+  __m128 ym2 = _mm_shuffle_ps(m_outdelay, m_outdelay, 0x55);
+  __m256 xd1 = _mm256_insertf128_ps(_mm256_castps128_ps256(xm1), xm1, 1);
+  __m256 xd2 = _mm256_insertf128_ps(_mm256_castps128_ps256(xm2), xm2, 1);
+  __m256 yd1 = _mm256_insertf128_ps(_mm256_castps128_ps256(ym1), ym1, 1);
+  __m256 yd2 = _mm256_insertf128_ps(_mm256_castps128_ps256(ym2), ym2, 1);
+
+  __m256 x;
+  __m256 y;
+  while (in != inend)
+  {
+    x = _mm256_loadu_ps(in);
+
+    //4 independent sums of products
+    __m256 sum0 = _mm256_add_ps(_mm256_mul_ps(col[0], _mm256_broadcast_ss(in + 0)),
+                                _mm256_mul_ps(col[1], _mm256_broadcast_ss(in + 1)));
+    __m256 sum1 = _mm256_add_ps(_mm256_mul_ps(col[2], _mm256_broadcast_ss(in + 2)),
+                                _mm256_mul_ps(col[3], _mm256_broadcast_ss(in + 3)));
+    __m256 sum2 = _mm256_add_ps(_mm256_mul_ps(col[4], _mm256_broadcast_ss(in + 4)),
+                                _mm256_mul_ps(col[5], _mm256_broadcast_ss(in + 5)));
+    __m256 sum3 = _mm256_add_ps(_mm256_mul_ps(col[6], _mm256_broadcast_ss(in + 6)),
+                                _mm256_mul_ps(col[7], _mm256_broadcast_ss(in + 7)));
+    sum0 = _mm256_add_ps(sum0, _mm256_add_ps(_mm256_mul_ps(col[8], xd1), _mm256_mul_ps(col[9], xd2)));
+    sum1 = _mm256_add_ps(sum1, _mm256_add_ps(_mm256_mul_ps(col[10], yd1), _mm256_mul_ps(col[11], yd2)));
+    y = _mm256_add_ps(_mm256_add_ps(sum0, sum1), _mm256_add_ps(sum2, sum3));
+
+    _mm256_storeu_ps(out, y);
+
+    //broadcast the last two input and output samples for the next block
+    __m256 xhigh = _mm256_permute2f128_ps(x, x, 0x11);
+    __m256 yhigh = _mm256_permute2f128_ps(y, y, 0x11);
+    xd1 = _mm256_permute_ps(xhigh, 0xFF);
+    xd2 = _mm256_permute_ps(xhigh, 0xAA);
+    yd1 = _mm256_permute_ps(yhigh, 0xFF);
+    yd2 = _mm256_permute_ps(yhigh, 0xAA);
+
+    in  += BIQUAD_BLOCK;
+    out += BIQUAD_BLOCK;
+  }
 
-      //add the input and output samples together
-      __m128 addvec = _mm_add_ps(invec, outvec);
+  //store the last 4 input and output samples in reverse order, the layout RunSingle uses
+  __m128 xlast = _mm256_extractf128_ps(x, 1);
+  __m128 ylast = _mm256_extractf128_ps(y, 1);
+  m_indelay  = _mm_shuffle_ps(xlast, xlast, 0x1B);
+  m_outdelay = _mm_shuffle_ps(ylast, ylast, 0x1B);
 
-      //add the 3 calculated samples to the most right float of outvec
-      outvec = _mm_movehl_ps(addvec, addvec);
-      outvec = _mm_add_ps(outvec, addvec);
-      addvec = _mm_shuffle_ps(addvec, addvec, 0x39);
-      outvec = _mm_add_ss(outvec, addvec);
+  _mm256_zeroupper();
+}
+#else
+void INLINE OPTIMIZE CBiquad::RunBlock(float*& in, float* inend, float*& out)
+{
+  if (in == inend)
+    return;
 
-      //store the calculated output value
-      _mm_store_ss(out++, outvec);
+  __m128 col[BIQUAD_MATRIXCOLS];
+  for (int i = 0; i < BIQUAD_MATRIXCOLS; i++)
+    col[i] = _mm_loadu_ps(m_matrix[i]);
 
-      //shift the values in m_outdelay one to the left
-      //then add the value in outvec
-      outvec = _mm_unpacklo_ps(outvec, m_outdelay);
-      m_outdelay = _mm_shuffle_ps(outvec, m_outdelay, 0x94);
+  //m_indelay holds x[n - 1] in the lowest float, x[n - 2] in the next, m_outdelay the same for y
+  __m128 xd1 = _mm_shuffle_ps(m_indelay, m_indelay, 0x00);
+  __m128 xd2 = _mm_shuffle_ps(m_indelay, m_indelay, 0x55);
+  __m128 yd1 = _mm_shuffle_ps(m_outdelay, m_outdelay, 0x00);
+  __m128 yd2 = _mm_shuffle_ps(m_outdelay, m_outdelay, 0x55);
 
-      //rotate inload to use the next sample
-      inload = _mm_shuffle_ps(inload, inload, 0x39);
-    }
+  __m128 x;
+  __m128 y;
+  while (in != inend)
+  {
+    x = _mm_loadu_ps(in);
+
+    //4 independent sums of products
+    __m128 sum0 = _mm_add_ps(_mm_mul_ps(col[0], _mm_shuffle_ps(x, x, 0x00)),
+                             _mm_mul_ps(col[1], _mm_shuffle_ps(x, x, 0x55)));
+    __m128 sum1 = _mm_add_ps(_mm_mul_ps(col[2], _mm_shuffle_ps(x, x, 0xAA)),
+                             _mm_mul_ps(col[3], _mm_shuffle_ps(x, x, 0xFF)));
+    __m128 sum2 = _mm_add_ps(_mm_mul_ps(col[4], xd1), _mm_mul_ps(col[5], xd2));
+    __m128 sum3 = _mm_add_ps(_mm_mul_ps(col[6], yd1), _mm_mul_ps(col[7], yd2));
+    y = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_add_ps(sum2, sum3));
+
+    _mm_storeu_ps(out, y);
+
+    //broadcast the last two input and output samples for the next block
+    xd1 = _mm_shuffle_ps(x, x, 0xFF);
+    xd2 = _mm_shuffle_ps(x, x, 0xAA);
+    yd1 = _mm_shuffle_ps(y, y, 0xFF);
+    yd2 = _mm_shuffle_ps(y, y, 0xAA);
+
+    in  += BIQUAD_BLOCK;
+    out += BIQUAD_BLOCK;
   }
+
+  //store the last 4 input and output samples in reverse order, the layout RunSingle uses
+  m_indelay  = _mm_shuffle_ps(x, x, 0x1B);
+  m_outdelay = _mm_shuffle_ps(y, y, 0x1B);
 }
 #endif
+#endif
 
 void CBiquad::Deactivate()
 {
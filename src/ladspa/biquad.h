@@ -26,6 +26,30 @@
 #include "filterdescriptions.h"
 #include "filterinterface.h"
 
+//number of samples the block kernel calculates per iteration
+#ifdef __AVX__
+  #define BIQUAD_BLOCK 8
+#else
+  #define BIQUAD_BLOCK 4
+#endif
+
+//the block kernel multiplies the block of input samples and the 4 delayed samples with a matrix
+#define BIQUAD_MATRIXCOLS (BIQUAD_BLOCK + 4)
+
+//when the controls change, the coefficients move to the new values in this many seconds
+#define BIQUAD_RAMPTIME 0.05f
+
+//coefficients in the order they are interpolated
+enum EBIQUADCOEF
+{
+  COEF_B0,
+  COEF_B1,
+  COEF_B2,
+  COEF_A1,
+  COEF_A2,
+  COEF_NUM
+};
+
 namespace BobDSPLadspa
 {
   class CBiquad : public IFilter
@@ -38,11 +62,18 @@ namespace BobDSPLadspa
       void Activate();
       void Run(unsigned long samplecount);
       void Deactivate();
+      bool IsIdentity();
+      void Skipped();
 
     private:
+      void ClearDelays();
+      void UpdateCoefs();
+      void StartRamp();
+      void RunRamp(float*& in, float* inend, float*& out);
 #ifdef USE_SSE
       void RunSingle(float*& in, float* inend, float*& out, __m128 acoeffs, __m128 bcoeffs);
-      void RunQuad(float*& in, float* inend, float*& out, __m128 acoeffs, __m128 bcoeffs);
+      void RunBlock(float*& in, float* inend, float*& out);
+      void CalculateMatrix();
 #endif
 
       EFILTER      m_type;
@@ -50,9 +81,22 @@ namespace BobDSPLadspa
       float        m_samplerate;
       LADSPA_Data* m_ports[6];
 
+      //while m_rampleft is not 0, the coefficients move linearly from the old to the new values,
+      //the coefficients of every sample are then a stable filter too, since the stability
+      //region of a1 and a2 is a triangle, and a line between two points in it stays in it
+      bool         m_jump; //when set, the next coefficients are applied without a ramp
+      int          m_rampleft;
+      float        m_ramp[COEF_NUM];
+      float        m_rampstep[COEF_NUM];
+
 #ifdef USE_SSE
       __m128       m_indelay;
       __m128       m_outdelay;
+      bool         m_matrixvalid;
+
+      //every column is the response of BIQUAD_BLOCK output samples to one of
+      //x[n] .. x[n + BIQUAD_BLOCK - 1], x[n - 1], x[n - 2], y[n - 1] and y[n - 2]
+      float        m_matrix[BIQUAD_MATRIXCOLS][BIQUAD_BLOCK];
 #else
       LADSPA_Data  m_indelay[2];
       LADSPA_Data  m_outdelay[2];
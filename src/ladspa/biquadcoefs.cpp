@@ -25,6 +25,7 @@ using namespace BobDSPLadspa;
 CBiquadCoef::CBiquadCoef()
 {
   m_initialized = false;
+  m_active      = false;
   memset(m_oldsettings, 0, sizeof(m_oldsettings));
   Passthrough();
 }
@@ -33,12 +34,38 @@ CBiquadCoef::~CBiquadCoef()
 {
 }
 
-void CBiquadCoef::Calculate(EFILTER type, float samplerate, LADSPA_Data** ports)
+bool CBiquadCoef::Calculate(EFILTER type, float samplerate, LADSPA_Data** ports)
 {
   if (type == LINKWITZTRANSFORM)
-    LinkwitzTransform(samplerate, ports);
+  {
+    return LinkwitzTransform(samplerate, ports);
+  }
   else
+  {
     Passthrough();
+    return false;
+  }
+}
+
+//only calculate the coefficients if the parameters changed
+//or when the coefficients have not been calculated
+bool CBiquadCoef::Changed(LADSPA_Data** settings)
+{
+  bool changed = false;
+  for (int i = 0; i < 4; i++)
+  {
+    if (m_oldsettings[i] != *settings[i])
+    {
+      changed = true;
+      m_oldsettings[i] = *settings[i];
+    }
+  }
+
+  if (!changed && m_initialized)
+    return false;
+
+  m_initialized = true;
+  return true;
 }
 
 //fallback filter, output = input
@@ -50,12 +77,14 @@ void CBiquadCoef::Passthrough()
   b0 = 1.0f;
   b1 = 0.0f;
   b2 = 0.0f;
+
+  m_active = false;
 }
 
 //ported from the spreadsheet at http://www.minidsp.com/applications/advanced-tools/linkwitz-transform
 //I don't understand what's going on here, so I can't explain what it's doing
 
-void CBiquadCoef::LinkwitzTransform(float samplerate, LADSPA_Data** ports)
+bool CBiquadCoef::LinkwitzTransform(float samplerate, LADSPA_Data** ports)
 {
   /*
     B3 = f0
@@ -82,22 +111,10 @@ void CBiquadCoef::LinkwitzTransform(float samplerate, LADSPA_Data** ports)
   
     */
 
-  //only calculate the coefficients if the parameters changed
-  //or when the coefficients have not been calculated
-  bool changed = false;
-  for (int i = 0; i < 4; i++)
-  {
-    if (m_oldsettings[i] != *ports[i + 2])
-    {
-      changed = true;
-      m_oldsettings[i] = *ports[i + 2];
-    }
-  }
+  if (!Changed(ports + 2))
+    return false;
 
-  if (!changed && m_initialized)
-    return;
-
-  m_initialized = true;
+  m_active = true;
 
   //clamp frequencies and Q factors to something sane
   LADSPA_Data f0 = Clamp(*ports[2], 1.0f, samplerate * 0.4f);
@@ -120,5 +137,105 @@ void CBiquadCoef::LinkwitzTransform(float samplerate, LADSPA_Data** ports)
   b0 = (B26 + B34 * B27 + powf(B34, 2.0f)) / B35;
   b1 = 2.0f * (B26 - powf(B34, 2.0f)) / B35;
   b2 = (B26 - B34 * B27 + powf(B34, 2.0f)) / B35;
+
+  return true;
+}
+
+//coefficients from the audio eq cookbook by Robert Bristow-Johnson
+//http://www.musicdsp.org/files/Audio-EQ-Cookbook.txt
+bool CBiquadCoef::CalculateEqBand(float samplerate, LADSPA_Data** bandports)
+{
+  if (!Changed(bandports))
+    return false;
+
+  int         type = Clamp(Round32(*bandports[0]), (int)EQ_OFF, (int)EQ_NUMBANDTYPES - 1);
+  LADSPA_Data freq = Clamp(*bandports[1], 1.0f, samplerate * 0.49f);
+  LADSPA_Data q    = Clamp(*bandports[2], 0.01f, 50.0f);
+  LADSPA_Data gain = Clamp(*bandports[3], -60.0f, 60.0f);
+
+  //peaking and shelving filters with no gain don't change the signal
+  if (type == EQ_OFF || (gain == 0.0f && (type == EQ_PEAKING || type == EQ_LOWSHELF || type == EQ_HIGHSHELF)))
+  {
+    Passthrough();
+    return true;
+  }
+
+  double A     = pow(10.0, gain / 40.0);
+  double w0    = 2.0 * M_PI * freq / samplerate;
+  double cosw0 = cos(w0);
+  double alpha = sin(w0) / (2.0 * q);
+  double sqrtA = sqrt(A);
+
+  double ca0, ca1, ca2, cb0, cb1, cb2;
+  if (type == EQ_PEAKING)
+  {
+    cb0 = 1.0 + alpha * A;
+    cb1 = -2.0 * cosw0;
+    cb2 = 1.0 - alpha * A;
+    ca0 = 1.0 + alpha / A;
+    ca1 = -2.0 * cosw0;
+    ca2 = 1.0 - alpha / A;
+  }
+  else if (type == EQ_LOWSHELF)
+  {
+    cb0 = A * ((A + 1.0) - (A - 1.0) * cosw0 + 2.0 * sqrtA * alpha);
+    cb1 = 2.0 * A * ((A - 1.0) - (A + 1.0) * cosw0);
+    cb2 = A * ((A + 1.0) - (A - 1.0) * cosw0 - 2.0 * sqrtA * alpha);
+    ca0 = (A + 1.0) + (A - 1.0) * cosw0 + 2.0 * sqrtA * alpha;
+    ca1 = -2.0 * ((A - 1.0) + (A + 1.0) * cosw0);
+    ca2 = (A + 1.0) + (A - 1.0) * cosw0 - 2.0 * sqrtA * alpha;
+  }
+  else if (type == EQ_HIGHSHELF)
+  {
+    cb0 = A * ((A + 1.0) + (A - 1.0) * cosw0 + 2.0 * sqrtA * alpha);
+    cb1 = -2.0 * A * ((A - 1.0) + (A + 1.0) * cosw0);
+    cb2 = A * ((A + 1.0) + (A - 1.0) * cosw0 - 2.0 * sqrtA * alpha);
+    ca0 = (A + 1.0) - (A - 1.0) * cosw0 + 2.0 * sqrtA * alpha;
+    ca1 = 2.0 * ((A - 1.0) - (A + 1.0) * cosw0);
+    ca2 = (A + 1.0) - (A - 1.0) * cosw0 - 2.0 * sqrtA * alpha;
+  }
+  else
+  {
+    //the other filters have the same poles
+    ca0 = 1.0 + alpha;
+    ca1 = -2.0 * cosw0;
+    ca2 = 1.0 - alpha;
+
+    if (type == EQ_LOWPASS)
+    {
+      cb0 = (1.0 - cosw0) / 2.0;
+      cb1 = 1.0 - cosw0;
+      cb2 = (1.0 - cosw0) / 2.0;
+    }
+    else if (type == EQ_HIGHPASS)
+    {
+      cb0 = (1.0 + cosw0) / 2.0;
+      cb1 = -(1.0 + cosw0);
+      cb2 = (1.0 + cosw0) / 2.0;
+    }
+    else if (type == EQ_NOTCH)
+    {
+      cb0 = 1.0;
+      cb1 = -2.0 * cosw0;
+      cb2 = 1.0;
+    }
+    else //EQ_ALLPASS
+    {
+      cb0 = 1.0 - alpha;
+      cb1 = -2.0 * cosw0;
+      cb2 = 1.0 + alpha;
+    }
+  }
+
+  //normalize to a0, the a coefficients are negated, the same as the linkwitz transform
+  a0 = 1.0f;
+  a1 = -ca1 / ca0;
+  a2 = -ca2 / ca0;
+  b0 = cb0 / ca0;
+  b1 = cb1 / ca0;
+  b2 = cb2 / ca0;
+
+  m_active = true;
+  return true;
 }
 
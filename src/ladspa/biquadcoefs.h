@@ -22,6 +22,20 @@
 #include <ladspa.h>
 #include "filterdescriptions.h"
 
+//filter types of a band of the parametric equalizer
+enum EEQBAND
+{
+  EQ_OFF,
+  EQ_PEAKING,
+  EQ_LOWSHELF,
+  EQ_HIGHSHELF,
+  EQ_LOWPASS,
+  EQ_HIGHPASS,
+  EQ_NOTCH,
+  EQ_ALLPASS,
+  EQ_NUMBANDTYPES
+};
+
 namespace BobDSPLadspa
 {
   class CBiquadCoef
@@ -30,7 +44,14 @@ namespace BobDSPLadspa
       CBiquadCoef();
       ~CBiquadCoef();
 
-      void Calculate(EFILTER type, float samplerate, LADSPA_Data** ports);
+      //these return true when the coefficients changed
+      bool Calculate(EFILTER type, float samplerate, LADSPA_Data** ports);
+
+      //bandports points to the type, frequency, Q and gain ports of a parametric equalizer band
+      bool CalculateEqBand(float samplerate, LADSPA_Data** bandports);
+
+      //false when the filter doesn't change the signal
+      bool IsActive() { return m_active; }
 
       LADSPA_Data a0;
       LADSPA_Data a1;
@@ -40,10 +61,12 @@ namespace BobDSPLadspa
       LADSPA_Data b2;
 
     private:
+      bool Changed(LADSPA_Data** settings);
       void Passthrough();
-      void LinkwitzTransform(float samplerate, LADSPA_Data** ports);
+      bool LinkwitzTransform(float samplerate, LADSPA_Data** ports);
 
       bool        m_initialized;
+      bool        m_active;
       LADSPA_Data m_oldsettings[4];
   };
 }
@@ -0,0 +1,363 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "compressor.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+enum ECMPMODE
+{
+  MODE_COMPRESS,
+  MODE_EXPAND,
+  MODE_GATE,
+};
+
+//detector levels are clipped to this, so that the log stays finite
+#define CMP_FLOOR 1e-12f
+
+#ifdef USE_SSE
+
+//log2 from the exponent bits, and a polynomial of the mantissa, within 0.001 dB
+static inline __m128 OPTIMIZE FastLog2(__m128 x)
+{
+  __m128i bits     = _mm_castps_si128(x);
+  __m128  exponent = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(127)));
+  __m128  mantissa = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)),
+                                                   _mm_set1_epi32(0x3F800000)));
+
+  __m128 poly = _mm_set1_ps(-0.08477615f);
+  poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(0.57993549f));
+  poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(-1.58549118f));
+  poly = _mm_add_ps(_mm_mul_ps(poly, mantissa), _mm_set1_ps(2.52934691f));
+  poly = _mm_mul_ps(poly, _mm_sub_ps(mantissa, _mm_set1_ps(1.0f)));
+
+  return _mm_add_ps(exponent, poly);
+}
+
+//exp2 from a polynomial of the fraction, scaled by the integer part put in the exponent bits
+static inline __m128 OPTIMIZE FastExp2(__m128 x)
+{
+  x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.0f)), _mm_set1_ps(126.0f));
+
+  //truncation rounds negative numbers up, correct that to get the floor
+  __m128i integer  = _mm_cvttps_epi32(x);
+  __m128  whole    = _mm_cvtepi32_ps(integer);
+  __m128  roundup  = _mm_cmpgt_ps(whole, x);
+  integer = _mm_add_epi32(integer, _mm_castps_si128(roundup));
+  whole   = _mm_sub_ps(whole, _mm_and_ps(roundup, _mm_set1_ps(1.0f)));
+
+  __m128 fraction = _mm_sub_ps(x, whole);
+  __m128 poly = _mm_set1_ps(0.07706128f);
+  poly = _mm_add_ps(_mm_mul_ps(poly, fraction), _mm_set1_ps(0.22765089f));
+  poly = _mm_add_ps(_mm_mul_ps(poly, fraction), _mm_set1_ps(0.69511564f));
+  poly = _mm_add_ps(_mm_mul_ps(poly, fraction), _mm_set1_ps(1.0f));
+
+  __m128 scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(integer, _mm_set1_epi32(127)), 23));
+
+  return _mm_mul_ps(poly, scale);
+}
+
+//one sample of all channels through the envelope followers,
+//the attack coefficient is used where the input is above the envelope
+static inline __m128 OPTIMIZE Follow(__m128 x, __m128 env, __m128 attack, __m128 release)
+{
+  __m128 rising = _mm_cmpgt_ps(x, env);
+  __m128 coef   = _mm_or_ps(_mm_and_ps(rising, attack), _mm_andnot_ps(rising, release));
+  return _mm_add_ps(env, _mm_mul_ps(coef, _mm_sub_ps(x, env)));
+}
+
+//the peak detector follows the absolute value,
+//the rms detector follows the mean square, averaged over CMP_RMSTIME
+template <bool rms>
+static inline __m128 OPTIMIZE DetectorInput(__m128 x, __m128& avg, __m128 avgcoef)
+{
+  if (rms)
+  {
+    avg = _mm_add_ps(avg, _mm_mul_ps(avgcoef, _mm_sub_ps(_mm_mul_ps(x, x), avg)));
+    return avg;
+  }
+  else
+  {
+    return _mm_and_ps(x, _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+  }
+}
+
+//runs the envelope followers, and returns the highest envelope of every channel,
+//four samples of every channel are transposed so that each sample is one vector
+template <bool rms>
+static void OPTIMIZE DetectBlock(const float* const* in, int samples, float* avgstate, float* envstate,
+                                 float avgcoef, float attackcoef, float releasecoef, float* level)
+{
+  __m128 avg     = _mm_loadu_ps(avgstate);
+  __m128 rmscoef = _mm_set1_ps(avgcoef);
+  __m128 env     = _mm_loadu_ps(envstate);
+  __m128 attack  = _mm_set1_ps(attackcoef);
+  __m128 release = _mm_set1_ps(releasecoef);
+  __m128 highest = _mm_setzero_ps();
+
+  int i = 0;
+  for (; i + 4 <= samples; i += 4)
+  {
+    __m128 r0 = _mm_loadu_ps(in[0] + i);
+    __m128 r1 = _mm_loadu_ps(in[1] + i);
+    __m128 r2 = _mm_loadu_ps(in[2] + i);
+    __m128 r3 = _mm_loadu_ps(in[3] + i);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+    env = Follow(DetectorInput<rms>(r0, avg, rmscoef), env, attack, release);
+    highest = _mm_max_ps(highest, env);
+    env = Follow(DetectorInput<rms>(r1, avg, rmscoef), env, attack, release);
+    highest = _mm_max_ps(highest, env);
+    env = Follow(DetectorInput<rms>(r2, avg, rmscoef), env, attack, release);
+    highest = _mm_max_ps(highest, env);
+    env = Follow(DetectorInput<rms>(r3, avg, rmscoef), env, attack, release);
+    highest = _mm_max_ps(highest, env);
+  }
+
+  for (; i < samples; i++)
+  {
+    __m128 x = _mm_setr_ps(in[0][i], in[1][i], in[2][i], in[3][i]);
+    env = Follow(DetectorInput<rms>(x, avg, rmscoef), env, attack, release);
+    highest = _mm_max_ps(highest, env);
+  }
+
+  _mm_storeu_ps(avgstate, avg);
+  _mm_storeu_ps(envstate, env);
+  _mm_storeu_ps(level, highest);
+}
+
+#else
+
+template <bool rms>
+static void DetectBlock(const float* const* in, int samples, float* avgstate, float* envstate,
+                        float avgcoef, float attackcoef, float releasecoef, float* level)
+{
+  for (int channel = 0; channel < CMP_CHANNELS; channel++)
+  {
+    const float* data    = in[channel];
+    float        avg     = avgstate[channel];
+    float        env     = envstate[channel];
+    float        highest = 0.0f;
+    for (int i = 0; i < samples; i++)
+    {
+      float x;
+      if (rms)
+      {
+        avg += avgcoef * (data[i] * data[i] - avg);
+        x = avg;
+      }
+      else
+      {
+        x = fabsf(data[i]);
+      }
+
+      env += (x > env ? attackcoef : releasecoef) * (x - env);
+      highest = Max(highest, env);
+    }
+    avgstate[channel] = avg;
+    envstate[channel] = env;
+    level[channel]    = highest;
+  }
+}
+
+#endif
+
+CCompressor::CCompressor(unsigned long samplerate)
+{
+  memset(m_ports, 0, sizeof(m_ports));
+  m_samplerate = samplerate;
+  m_avgcoef    = 1.0f - expf(-1.0f / (CMP_RMSTIME * samplerate));
+  m_rms        = false;
+  m_link       = 0;
+  m_attack     = 1.0f;
+  m_release    = 1.0f;
+  m_dbscale    = 0.0f;
+  m_direction  = 1.0f;
+  m_threshold  = 0.0f;
+  m_slope      = 0.0f;
+  m_knee       = 0.0f;
+  m_range      = 0.0f;
+  m_makeup     = 0.0f;
+  Activate();
+}
+
+CCompressor::~CCompressor()
+{
+}
+
+void CCompressor::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CCompressor::Activate()
+{
+  for (int channel = 0; channel < CMP_CHANNELS; channel++)
+  {
+    m_avg[channel]  = 0.0f;
+    m_env[channel]  = 0.0f;
+    m_gain[channel] = 1.0f;
+  }
+}
+
+void CCompressor::Run(unsigned long samplecount)
+{
+  Setup();
+
+  float reduction = 0.0f;
+  for (unsigned long i = 0; i < samplecount; i += CMP_STEP)
+  {
+    int   samples = Min((int)(samplecount - i), CMP_STEP);
+    float level[CMP_CHANNELS];
+    float gain[CMP_CHANNELS];
+
+    Detect(i, samples, level);
+    reduction = Max(reduction, ComputeGain(level, gain));
+    Apply(i, samples, gain);
+  }
+
+  *m_ports[CMP_REDUCTION] = reduction;
+}
+
+void CCompressor::Deactivate()
+{
+}
+
+void CCompressor::Setup()
+{
+  int   mode  = Clamp(Round32(*m_ports[CMP_MODE]), (int)MODE_COMPRESS, (int)MODE_GATE);
+  float ratio = Max(*m_ports[CMP_RATIO], 1.0f);
+
+  m_rms       = Round32(*m_ports[CMP_DETECTOR]) != 0;
+  m_link      = Clamp(Round32(*m_ports[CMP_LINK]), 0, 2);
+  m_attack    = 1.0f - expf(-1000.0f / (Max(*m_ports[CMP_ATTACK], 0.01f) * m_samplerate));
+  m_release   = 1.0f - expf(-1000.0f / (Max(*m_ports[CMP_RELEASE], 0.01f) * m_samplerate));
+  //the rms detector level is a mean square
+  m_dbscale   = m_rms ? 10.0f * log10f(2.0f) : 20.0f * log10f(2.0f);
+  m_direction = mode == MODE_COMPRESS ? 1.0f : -1.0f;
+  m_threshold = *m_ports[CMP_THRESHOLD];
+  if (mode == MODE_COMPRESS)
+    m_slope = 1.0f - 1.0f / ratio;
+  else if (mode == MODE_EXPAND)
+    m_slope = ratio - 1.0f;
+  else
+    m_slope = CMP_GATESLOPE;
+  //a tiny knee keeps the knee curve from dividing by zero
+  m_knee      = Max(*m_ports[CMP_KNEE], 0.01f);
+  m_range     = -Min(*m_ports[CMP_RANGE], 0.0f);
+  m_makeup    = *m_ports[CMP_MAKEUP];
+}
+
+void CCompressor::Detect(unsigned long start, int samples, float* level)
+{
+  const float* in[CMP_CHANNELS];
+  for (int channel = 0; channel < CMP_CHANNELS; channel++)
+    in[channel] = m_ports[CMP_IN1 + channel] + start;
+
+  if (m_rms)
+    DetectBlock<true>(in, samples, m_avg, m_env, m_avgcoef, m_attack, m_release, level);
+  else
+    DetectBlock<false>(in, samples, m_avg, m_env, m_avgcoef, m_attack, m_release, level);
+}
+
+//computes the linear gain of every channel from the detector levels, and returns the highest reduction in dB,
+//with d the dB over the threshold, the reduction is slope * d above the knee,
+//and slope * (d + knee / 2)^2 / (2 * knee) inside it
+float OPTIMIZE CCompressor::ComputeGain(const float* level, float* gain)
+{
+#ifdef USE_SSE
+  __m128 x = _mm_loadu_ps(level);
+
+  //linked channels use the highest level of their group
+  if (m_link >= 1)
+    x = _mm_max_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(2, 3, 0, 1)));
+  if (m_link >= 2)
+    x = _mm_max_ps(x, _mm_shuffle_ps(x, x, _MM_SHUFFLE(1, 0, 3, 2)));
+
+  __m128 db       = _mm_mul_ps(FastLog2(_mm_max_ps(x, _mm_set1_ps(CMP_FLOOR))), _mm_set1_ps(m_dbscale));
+  __m128 over     = _mm_mul_ps(_mm_sub_ps(db, _mm_set1_ps(m_threshold)), _mm_set1_ps(m_direction));
+  __m128 halfknee = _mm_set1_ps(m_knee * 0.5f);
+
+  __m128 inknee = _mm_min_ps(_mm_max_ps(_mm_add_ps(over, halfknee), _mm_setzero_ps()), _mm_set1_ps(m_knee));
+  __m128 above  = _mm_max_ps(_mm_sub_ps(over, halfknee), _mm_setzero_ps());
+  __m128 curve  = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(inknee, inknee), _mm_set1_ps(0.5f / m_knee)), above);
+  __m128 reduce = _mm_min_ps(_mm_mul_ps(curve, _mm_set1_ps(m_slope)), _mm_set1_ps(m_range));
+
+  __m128 gaindb = _mm_sub_ps(_mm_set1_ps(m_makeup), reduce);
+  _mm_storeu_ps(gain, FastExp2(_mm_mul_ps(gaindb, _mm_set1_ps(1.0f / (20.0f * log10f(2.0f))))));
+
+  reduce = _mm_max_ps(reduce, _mm_shuffle_ps(reduce, reduce, _MM_SHUFFLE(2, 3, 0, 1)));
+  reduce = _mm_max_ps(reduce, _mm_shuffle_ps(reduce, reduce, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm_cvtss_f32(reduce);
+#else
+  float linked[CMP_CHANNELS];
+  for (int channel = 0; channel < CMP_CHANNELS; channel++)
+  {
+    linked[channel] = level[channel];
+    if (m_link >= 1)
+      linked[channel] = Max(linked[channel], level[channel ^ 1]);
+    if (m_link >= 2)
+      linked[channel] = Max(linked[channel], Max(level[channel ^ 2], level[channel ^ 3]));
+  }
+
+  float highest = 0.0f;
+  for (int channel = 0; channel < CMP_CHANNELS; channel++)
+  {
+    float db     = log2f(Max(linked[channel], CMP_FLOOR)) * m_dbscale;
+    float over   = (db - m_threshold) * m_direction;
+    float inknee = Clamp(over + m_knee * 0.5f, 0.0f, m_knee);
+    float above  = Max(over - m_knee * 0.5f, 0.0f);
+    float reduce = Min((inknee * inknee * 0.5f / m_knee + above) * m_slope, m_range);
+
+    gain[channel] = exp2f((m_makeup - reduce) / (20.0f * log10f(2.0f)));
+    highest = Max(highest, reduce);
+  }
+
+  return highest;
+#endif
+}
+
+//ramps the gain of every channel linearly from the last step to the new one
+void OPTIMIZE CCompressor::Apply(unsigned long start, int samples, const float* gain)
+{
+  for (int channel = 0; channel < CMP_CHANNELS; channel++)
+  {
+    const float* in   = m_ports[CMP_IN1 + channel] + start;
+    float*       out  = m_ports[CMP_OUT1 + channel] + start;
+    float        prev = m_gain[channel];
+    float        step = (gain[channel] - prev) / samples;
+
+    int i = 0;
+#ifdef USE_SSE
+    __m128 ramp  = _mm_add_ps(_mm_set1_ps(prev), _mm_mul_ps(_mm_set1_ps(step), _mm_setr_ps(1.0f, 2.0f, 3.0f, 4.0f)));
+    __m128 step4 = _mm_set1_ps(step * 4.0f);
+    for (; i + 4 <= samples; i += 4)
+    {
+      _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), ramp));
+      ramp = _mm_add_ps(ramp, step4);
+    }
+#endif
+    for (; i < samples; i++)
+      out[i] = in[i] * (prev + step * (i + 1));
+
+    m_gain[channel] = gain[channel];
+  }
+}
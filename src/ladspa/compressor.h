@@ -0,0 +1,96 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef COMPRESSOR_H
+#define COMPRESSOR_H
+
+#include "util/ssedefs.h"
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+
+//the channels run in the lanes of one sse vector
+#define CMP_CHANNELS   4
+
+#define CMP_IN1        0
+#define CMP_OUT1       (CMP_IN1 + CMP_CHANNELS)
+#define CMP_MODE       (CMP_OUT1 + CMP_CHANNELS)
+#define CMP_DETECTOR   (CMP_MODE + 1)
+#define CMP_THRESHOLD  (CMP_MODE + 2)
+#define CMP_RATIO      (CMP_MODE + 3)
+#define CMP_KNEE       (CMP_MODE + 4)
+#define CMP_ATTACK     (CMP_MODE + 5)
+#define CMP_RELEASE    (CMP_MODE + 6)
+#define CMP_RANGE      (CMP_MODE + 7)
+#define CMP_MAKEUP     (CMP_MODE + 8)
+#define CMP_LINK       (CMP_MODE + 9)
+#define CMP_REDUCTION  (CMP_MODE + 10)
+#define CMP_NUMPORTS   (CMP_MODE + 11)
+
+//the gain is computed once every this many samples, and ramped linearly in between
+#define CMP_STEP       16
+
+//averaging time of the rms detector, in seconds
+#define CMP_RMSTIME    0.01f
+
+//the gate is an expander with this slope, the range sets how far it closes
+#define CMP_GATESLOPE  100.0f
+
+namespace BobDSPLadspa
+{
+  //compressor, expander and gate with peak or rms detection, the envelope followers and the
+  //gain computer run on all channels at once, the gain computer works in dB with fast log2 and exp2
+  class CCompressor : public IFilter
+  {
+    public:
+      CCompressor(unsigned long samplerate);
+      ~CCompressor();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+
+    private:
+      void  Setup();
+      void  Detect(unsigned long start, int samples, float* level);
+      float ComputeGain(const float* level, float* gain);
+      void  Apply(unsigned long start, int samples, const float* gain);
+
+      LADSPA_Data*  m_ports[CMP_NUMPORTS];
+      unsigned long m_samplerate;
+
+      float         m_avgcoef;   //rms averaging coefficient
+      bool          m_rms;
+      int           m_link;
+      float         m_attack;    //envelope follower coefficients
+      float         m_release;
+      float         m_dbscale;   //dB per octave of the detector level
+      float         m_direction; //1 to reduce above the threshold, -1 below it
+      float         m_threshold;
+      float         m_slope;     //dB of reduction per dB over the threshold
+      float         m_knee;
+      float         m_range;     //maximum reduction in dB
+      float         m_makeup;
+
+      float         m_avg[CMP_CHANNELS];
+      float         m_env[CMP_CHANNELS];
+      float         m_gain[CMP_CHANNELS]; //gain at the end of the last step
+  };
+}
+
+#endif //COMPRESSOR_H
@@ -0,0 +1,238 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "convolver.h"
+#include "util/misc.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+
+using namespace BobDSPLadspa;
+
+CConvolver::CConvolver(unsigned long samplerate)
+{
+  memset(m_ports, 0, sizeof(m_ports));
+
+  //until an impulse response is loaded, the input is copied to the output
+  m_engine     = new CConvolverEngine(NULL, -1);
+  m_fadeengine = NULL;
+  m_fadepos    = 0;
+  m_fadelength = Max(Round32(CONV_FADETIME * samplerate), 1);
+  m_newengine  = NULL;
+  m_oldengine  = NULL;
+  m_impulse    = -1;
+  m_loaded     = -1;
+  m_finished   = -1;
+  m_rtpriority = -1;
+  m_wait       = true;
+  m_late       = 0;
+  m_stop       = false;
+
+  //impulse responses are loaded, and the partitions are prepared, in a separate thread
+  sem_init(&m_loadsem, 0, 0);
+  pthread_create(&m_loader, NULL, LoaderThread, this);
+}
+
+CConvolver::~CConvolver()
+{
+  m_stop = true;
+  sem_post(&m_loadsem);
+  pthread_join(m_loader, NULL);
+  sem_destroy(&m_loadsem);
+
+  delete m_engine;
+  delete m_fadeengine;
+  delete m_newengine;
+  delete m_oldengine;
+}
+
+void CConvolver::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CConvolver::Activate()
+{
+}
+
+void CConvolver::Run(unsigned long samplecount)
+{
+  Update();
+
+  if (m_fadeengine)
+    Fade(m_ports[CONV_IN], m_ports[CONV_OUT], samplecount);
+  else
+    m_engine->Process(m_ports[CONV_IN], m_ports[CONV_OUT], samplecount, m_wait);
+
+  m_late += m_engine->TakeLate();
+  if (m_fadeengine)
+    m_late += m_fadeengine->TakeLate();
+
+  *m_ports[CONV_LATE] = m_late;
+}
+
+void CConvolver::Deactivate()
+{
+}
+
+bool CConvolver::IsIdentity()
+{
+  //the host doesn't call Run() while this returns true, so check for a new impulse response here too
+  Update();
+  return m_fadeengine == NULL && m_engine->IsEmpty();
+}
+
+//this is called before the first Run(), and from the realtime thread when it starts or stops being realtime,
+//when it's not realtime it waits for late worker threads, so that the output is the same as when they're on time
+//waits until the impulse response of the current control value is loaded, and its engine is taken,
+//unless a fade is still running, then Run() takes it after the fade
+void CConvolver::WaitLoaded()
+{
+  for(;;)
+  {
+    Update();
+    if (__atomic_load_n(&m_finished, __ATOMIC_ACQUIRE) == m_impulse &&
+        (__atomic_load_n(&m_newengine, __ATOMIC_ACQUIRE) == NULL || m_fadeengine != NULL))
+      break;
+
+    usleep(1000);
+  }
+}
+
+void CConvolver::SetRealtimePriority(int priority)
+{
+  __atomic_store_n(&m_rtpriority, priority, __ATOMIC_RELEASE);
+  m_wait = priority <= 0;
+}
+
+//fades the output of the old engine out, and the input of the new engine in,
+//the new engine starts without history, fading its input in makes its output start
+//smoothly, also where the impulse response has a delayed peak,
+//when the fade is done, the old engine is handed to the loader thread to delete it
+void CConvolver::Fade(const float* in, float* out, int samples)
+{
+  while (samples > 0 && m_fadeengine)
+  {
+    int   block = Min(samples, CONV_FADEBLOCK);
+    float step  = 1.0f / m_fadelength;
+    float gain  = m_fadepos * step;
+
+    //in may be the same buffer as out, so keep a copy for the old engine
+    memcpy(m_fadein, in, block * sizeof(float));
+    for (int i = 0; i < block; i++)
+      out[i] = m_fadein[i] * Min(gain + step * (i + 1), 1.0f);
+
+    m_engine->Process(out, out, block, m_wait);
+    m_fadeengine->Process(m_fadein, m_fadeout, block, m_wait);
+
+    for (int i = 0; i < block; i++)
+      out[i] += m_fadeout[i] * (1.0f - Min(gain + step * (i + 1), 1.0f));
+
+    m_fadepos += block;
+    if (m_fadepos >= m_fadelength)
+    {
+      __atomic_store_n(&m_oldengine, m_fadeengine, __ATOMIC_RELEASE);
+      m_fadeengine = NULL;
+      sem_post(&m_loadsem);
+    }
+
+    in      += block;
+    out     += block;
+    samples -= block;
+  }
+
+  if (samples > 0)
+    m_engine->Process(in, out, samples, m_wait);
+}
+
+void CConvolver::Update()
+{
+  bool wakeloader = false;
+
+  int impulse = Round32(*m_ports[CONV_IMPULSE]);
+  if (impulse != m_impulse)
+  {
+    __atomic_store_n(&m_impulse, impulse, __ATOMIC_RELEASE);
+    wakeloader = true;
+  }
+
+  //take the new engine from the loader thread, the old engine is faded out, then handed back to it to delete it,
+  //wait until the previous fade is done, and the loader thread has deleted the previous old engine
+  if (m_fadeengine == NULL && __atomic_load_n(&m_oldengine, __ATOMIC_ACQUIRE) == NULL)
+  {
+    CConvolverEngine* engine = __atomic_exchange_n(&m_newengine, NULL, __ATOMIC_ACQ_REL);
+    if (engine)
+    {
+      m_fadeengine = m_engine;
+      m_fadepos    = 0;
+      m_engine     = engine;
+      wakeloader   = true;
+    }
+  }
+
+  if (wakeloader)
+    sem_post(&m_loadsem);
+}
+
+void* CConvolver::LoaderThread(void* arg)
+{
+  CConvolver* convolver = (CConvolver*)arg;
+  for(;;)
+  {
+    while (sem_wait(&convolver->m_loadsem) != 0 && errno == EINTR);
+
+    if (convolver->m_stop)
+      break;
+
+    delete __atomic_exchange_n(&convolver->m_oldengine, NULL, __ATOMIC_ACQ_REL);
+
+    int impulse = __atomic_load_n(&convolver->m_impulse, __ATOMIC_ACQUIRE);
+    if (impulse != convolver->m_loaded)
+    {
+      convolver->m_loaded = impulse;
+      convolver->Load(impulse);
+      __atomic_store_n(&convolver->m_finished, impulse, __ATOMIC_RELEASE);
+    }
+  }
+
+  return NULL;
+}
+
+void CConvolver::Load(int impulse)
+{
+  CImpulse*   ir   = NULL;
+  const char* home = getenv("HOME");
+  if (home && impulse >= 0)
+  {
+    char name[32];
+    snprintf(name, sizeof(name), "%i", impulse);
+
+    std::string filename = std::string(home) + "/" IMPULSEDIR + name;
+    ir = CImpulse::Acquire(filename + ".wav");
+    if (!ir)
+      ir = CImpulse::Acquire(filename + ".raw");
+  }
+
+  //when the file can't be loaded, the engine copies the input to the output
+  //if the realtime thread didn't take the previous new engine yet, it's replaced
+  CConvolverEngine* engine = new CConvolverEngine(ir, __atomic_load_n(&m_rtpriority, __ATOMIC_ACQUIRE));
+  delete __atomic_exchange_n(&m_newengine, engine, __ATOMIC_ACQ_REL);
+}
@@ -0,0 +1,86 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONVOLVER_H
+#define CONVOLVER_H
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+#include "convolverengine.h"
+
+#define CONV_IN      0
+#define CONV_OUT     1
+#define CONV_IMPULSE 2
+#define CONV_LATE    3
+#define CONV_NUMPORTS 4
+
+//when a new impulse response is loaded, the old engine is faded out and the new one faded in over this time
+#define CONV_FADETIME  0.02f
+#define CONV_FADEBLOCK 256
+
+//impulse responses are loaded from $HOME/IMPULSEDIR/<number>.wav or <number>.raw
+#define IMPULSEDIR ".bobdsp/impulses/"
+
+namespace BobDSPLadspa
+{
+  class CConvolver : public IFilter
+  {
+    public:
+      CConvolver(unsigned long samplerate);
+      ~CConvolver();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+      bool IsIdentity();
+      void WaitLoaded();
+      void SetRealtimePriority(int priority);
+
+    private:
+      void              Update();
+      static void*      LoaderThread(void* arg);
+      void              Load(int impulse);
+      void              Fade(const float* in, float* out, int samples);
+
+      LADSPA_Data*      m_ports[CONV_NUMPORTS];
+      CConvolverEngine* m_engine;    //only used by the realtime thread
+      CConvolverEngine* m_fadeengine; //the previous engine while it's faded out, only used by the realtime thread
+      int               m_fadepos;
+      int               m_fadelength;
+      float             m_fadein[CONV_FADEBLOCK];
+      float             m_fadeout[CONV_FADEBLOCK];
+      CConvolverEngine* m_newengine; //handed from the loader thread to the realtime thread
+      CConvolverEngine* m_oldengine; //handed from the realtime thread to the loader thread to delete it
+      int               m_impulse;   //requested by the realtime thread
+      int               m_loaded;    //loaded by the loader thread
+      int               m_finished;  //m_loaded after its engine is made
+      int               m_rtpriority; //priority of the realtime thread, for the worker threads of the engines
+      bool              m_wait;       //the realtime thread may wait for the worker threads, when it's not realtime
+      int               m_late;       //number of late jobs of the worker threads
+
+      pthread_t         m_loader;
+      sem_t             m_loadsem;
+      volatile bool     m_stop;
+  };
+}
+
+#endif //CONVOLVER_H
@@ -0,0 +1,370 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "convolverengine.h"
+#include "util/misc.h"
+#include "util/ssedefs.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace BobDSPLadspa;
+
+static float* AllocBuffer(int size)
+{
+  float* buffer = (float*)aligned_alloc(ALIGN, size * sizeof(float));
+  memset(buffer, 0, size * sizeof(float));
+  return buffer;
+}
+
+//acc += a * b for complex numbers, size has to be a multiple of 4 and the buffers have to be aligned
+static void OPTIMIZE ComplexMultiplyAdd(const float* are, const float* aim, const float* bre, const float* bim,
+                                        float* accre, float* accim, int size)
+{
+#ifdef USE_SSE
+  for (int i = 0; i < size; i += 4)
+  {
+    __m128 ar = _mm_load_ps(are + i);
+    __m128 ai = _mm_load_ps(aim + i);
+    __m128 br = _mm_load_ps(bre + i);
+    __m128 bi = _mm_load_ps(bim + i);
+
+    __m128 re = _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi));
+    __m128 im = _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br));
+
+    _mm_store_ps(accre + i, _mm_add_ps(_mm_load_ps(accre + i), re));
+    _mm_store_ps(accim + i, _mm_add_ps(_mm_load_ps(accim + i), im));
+  }
+#else
+  for (int i = 0; i < size; i++)
+  {
+    accre[i] += are[i] * bre[i] - aim[i] * bim[i];
+    accim[i] += are[i] * bim[i] + aim[i] * bre[i];
+  }
+#endif
+}
+
+CConvolverLevel::CConvolverLevel(CImpulse* impulse, int level, bool threaded, int rtpriority) : m_fft(g_convblocksize[level] * 2)
+{
+  m_impulse    = impulse;
+  m_level      = level;
+  m_blocksize  = g_convblocksize[level];
+  m_partitions = impulse->Partitions(level);
+  m_stride     = CImpulse::BinStride(level);
+  m_pos        = 0;
+  m_fdlpos     = 0;
+  m_current    = 0;
+  m_threaded   = threaded;
+  m_busy       = false;
+  m_stop       = false;
+  m_jobblocks  = 0;
+  m_jobreset   = false;
+  m_missed     = 0;
+  m_lost       = false;
+  m_late       = 0;
+
+  //the padding bins after every spectrum stay zero, so the complex multiply can run on whole vectors
+  m_input     = AllocBuffer(m_blocksize * 2);
+  m_fdlre     = AllocBuffer(m_partitions * m_stride);
+  m_fdlim     = AllocBuffer(m_partitions * m_stride);
+  m_accre     = AllocBuffer(m_stride);
+  m_accim     = AllocBuffer(m_stride);
+  m_time      = AllocBuffer(m_blocksize * 2);
+  m_result[0] = AllocBuffer(m_blocksize);
+  m_result[1] = AllocBuffer(m_blocksize);
+  m_jobinput  = threaded ? AllocBuffer(m_blocksize * (CONV_MAXLATE + 2)) : NULL;
+  m_backlog   = threaded ? AllocBuffer(m_blocksize * (CONV_MAXLATE + 2)) : NULL;
+
+  if (m_threaded)
+  {
+    sem_init(&m_start, 0, 0);
+    sem_init(&m_done, 0, 0);
+    pthread_create(&m_thread, NULL, ThreadFunction, this);
+
+    //the realtime thread needs the result in time, so run just below its priority,
+    //other realtime threads below it then can't preempt the worker, levels with longer blocks
+    //have more time, so they get a lower priority, when the realtime thread isn't realtime,
+    //stay at the normal priority
+    if (rtpriority > 0)
+    {
+      struct sched_param param = {};
+      param.sched_priority = Max(rtpriority - 1 - level, sched_get_priority_min(SCHED_FIFO));
+      pthread_setschedparam(m_thread, SCHED_FIFO, &param);
+    }
+  }
+}
+
+CConvolverLevel::~CConvolverLevel()
+{
+  if (m_threaded)
+  {
+    m_stop = true;
+    sem_post(&m_start);
+    pthread_join(m_thread, NULL);
+    sem_destroy(&m_start);
+    sem_destroy(&m_done);
+  }
+
+  free(m_input);
+  free(m_fdlre);
+  free(m_fdlim);
+  free(m_accre);
+  free(m_accim);
+  free(m_time);
+  free(m_result[0]);
+  free(m_result[1]);
+  free(m_jobinput);
+  free(m_backlog);
+}
+
+void* CConvolverLevel::ThreadFunction(void* arg)
+{
+  CConvolverLevel* level = (CConvolverLevel*)arg;
+  for(;;)
+  {
+    while (sem_wait(&level->m_start) != 0 && errno == EINTR);
+
+    if (level->m_stop)
+      break;
+
+    //m_current doesn't change while the job runs, when blocks were missed
+    //every block is calculated, only the output of the last one is used
+    if (level->m_jobreset)
+    {
+      memset(level->m_fdlre, 0, level->m_partitions * level->m_stride * sizeof(float));
+      memset(level->m_fdlim, 0, level->m_partitions * level->m_stride * sizeof(float));
+    }
+
+    for (int block = 0; block < level->m_jobblocks; block++)
+      level->Calculate(level->m_jobinput + block * level->m_blocksize, level->m_result[!level->m_current]);
+
+    sem_post(&level->m_done);
+  }
+
+  return NULL;
+}
+
+void OPTIMIZE CConvolverLevel::Process(const float* in, float* out, int samples, bool wait)
+{
+  memcpy(m_input + m_blocksize + m_pos, in, samples * sizeof(float));
+
+  const float* result = m_result[m_current] + m_pos;
+  for (int i = 0; i < samples; i++)
+    out[i] += result[i];
+
+  m_pos += samples;
+  if (m_pos < m_blocksize)
+    return;
+
+  m_pos = 0;
+  if (m_threaded)
+  {
+    //the job that was started at the previous block boundary calculated the output for the next block
+    //it had a whole block of time, so it should be done already, if not the realtime thread only waits
+    //for it when it's allowed to, otherwise the current output block is played again
+    if (m_busy)
+    {
+      if (wait)
+      {
+        while (sem_wait(&m_done) != 0 && errno == EINTR);
+      }
+      else if (sem_trywait(&m_done) != 0)
+      {
+        //keep the input of this block for the next job, so that no block is left out of
+        //the frequency domain delay line, when too many are missed it's cleared instead
+        m_late++;
+        if (m_missed == 0)
+          memcpy(m_backlog, m_input, m_blocksize * 2 * sizeof(float));
+        else if (m_missed < CONV_MAXLATE)
+          memcpy(m_backlog + (m_missed + 1) * m_blocksize, m_input + m_blocksize, m_blocksize * sizeof(float));
+        else
+          m_lost = true;
+
+        m_missed = Min(m_missed + 1, CONV_MAXLATE);
+        memcpy(m_input, m_input + m_blocksize, m_blocksize * sizeof(float));
+        return;
+      }
+
+      m_current = !m_current;
+    }
+
+    //start the job for the block after the next one, with the blocks that were missed before it
+    if (m_missed > 0 && !m_lost)
+    {
+      memcpy(m_backlog + (m_missed + 1) * m_blocksize, m_input + m_blocksize, m_blocksize * sizeof(float));
+      memcpy(m_jobinput, m_backlog, (m_missed + 2) * m_blocksize * sizeof(float));
+      m_jobblocks = m_missed + 1;
+    }
+    else
+    {
+      memcpy(m_jobinput, m_input, m_blocksize * 2 * sizeof(float));
+      m_jobblocks = 1;
+    }
+
+    m_jobreset = m_lost;
+    m_missed   = 0;
+    m_lost     = false;
+    m_busy     = true;
+    sem_post(&m_start);
+  }
+  else
+  {
+    Calculate(m_input, m_result[m_current]);
+  }
+
+  //the current block becomes the previous block
+  memcpy(m_input, m_input + m_blocksize, m_blocksize * sizeof(float));
+}
+
+int CConvolverLevel::TakeLate()
+{
+  int late = m_late;
+  m_late = 0;
+  return late;
+}
+
+void CConvolverLevel::Calculate(const float* in, float* out)
+{
+  //store the spectrum of the last two blocks in the frequency domain delay line
+  m_fft.RealForward(in, m_fdlre + m_fdlpos * m_stride, m_fdlim + m_fdlpos * m_stride);
+
+  //multiply the spectrum of every block with the spectrum of the partition of the same age
+  memset(m_accre, 0, m_stride * sizeof(float));
+  memset(m_accim, 0, m_stride * sizeof(float));
+  const float* kernelre = m_impulse->KernelRe(m_level);
+  const float* kernelim = m_impulse->KernelIm(m_level);
+  int          fdlpos   = m_fdlpos;
+  for (int p = 0; p < m_partitions; p++)
+  {
+    ComplexMultiplyAdd(m_fdlre + fdlpos * m_stride, m_fdlim + fdlpos * m_stride,
+                       kernelre + p * m_stride, kernelim + p * m_stride,
+                       m_accre, m_accim, m_stride);
+
+    fdlpos = fdlpos == 0 ? m_partitions - 1 : fdlpos - 1;
+  }
+
+  //with overlap-save the first half is aliased by the circular convolution, the second half is the output
+  m_fft.RealInverse(m_accre, m_accim, m_time);
+  memcpy(out, m_time + m_blocksize, m_blocksize * sizeof(float));
+
+  m_fdlpos++;
+  if (m_fdlpos == m_partitions)
+    m_fdlpos = 0;
+}
+
+CConvolverEngine::CConvolverEngine(CImpulse* impulse, int rtpriority)
+{
+  m_impulse = impulse;
+  m_input   = AllocBuffer(CONV_HEADSIZE * 2);
+  m_pos     = 0;
+
+  for (int level = 0; level < CONV_LEVELS; level++)
+  {
+    if (impulse && impulse->Partitions(level) > 0)
+      m_levels[level] = new CConvolverLevel(impulse, level, level > 0, rtpriority);
+    else
+      m_levels[level] = NULL;
+  }
+}
+
+CConvolverEngine::~CConvolverEngine()
+{
+  for (int level = 0; level < CONV_LEVELS; level++)
+    delete m_levels[level];
+
+  free(m_input);
+  CImpulse::Release(m_impulse);
+}
+
+void CConvolverEngine::Process(const float* in, float* out, int samples, bool wait)
+{
+  if (!m_impulse)
+  {
+    memmove(out, in, samples * sizeof(float));
+    return;
+  }
+
+  //process up to the next block boundary of the head, the block sizes of all levels
+  //are multiples of the head size, so this never crosses their block boundaries
+  while (samples > 0)
+  {
+    int    block   = Min(samples, CONV_HEADSIZE - m_pos);
+    float* current = m_input + CONV_HEADSIZE + m_pos;
+    memcpy(current, in, block * sizeof(float));
+
+    ProcessHead(out, block);
+    for (int level = 0; level < CONV_LEVELS; level++)
+    {
+      if (m_levels[level])
+        m_levels[level]->Process(current, out, block, wait);
+    }
+
+    in      += block;
+    out     += block;
+    samples -= block;
+    m_pos   += block;
+
+    if (m_pos == CONV_HEADSIZE)
+    {
+      memcpy(m_input, m_input + CONV_HEADSIZE, CONV_HEADSIZE * sizeof(float));
+      m_pos = 0;
+    }
+  }
+}
+
+int CConvolverEngine::TakeLate()
+{
+  int late = 0;
+  for (int level = 0; level < CONV_LEVELS; level++)
+  {
+    if (m_levels[level])
+      late += m_levels[level]->TakeLate();
+  }
+
+  return late;
+}
+
+void OPTIMIZE CConvolverEngine::ProcessHead(float* out, int samples)
+{
+  //direct convolution with the head of the impulse response, the previous block
+  //is before the current one in m_input, so the history can be read without wrapping
+  const float* head = m_impulse->Head();
+  const float* x    = m_input + CONV_HEADSIZE + m_pos;
+  int i = 0;
+
+#ifdef USE_SSE
+  for (; i + 4 <= samples; i += 4)
+  {
+    __m128 sum = _mm_setzero_ps();
+    for (int k = 0; k < CONV_HEADSIZE; k++)
+      sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(head[k]), _mm_loadu_ps(x + i - k)));
+
+    _mm_storeu_ps(out + i, sum);
+  }
+#endif
+
+  for (; i < samples; i++)
+  {
+    float sum = 0.0f;
+    for (int k = 0; k < CONV_HEADSIZE; k++)
+      sum += head[k] * x[i - k];
+
+    out[i] = sum;
+  }
+}
@@ -0,0 +1,116 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CONVOLVERENGINE_H
+#define CONVOLVERENGINE_H
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "fft.h"
+#include "impulse.h"
+
+//when the worker thread of a level is late, the realtime thread keeps up to this many blocks of input
+//to give to it when it's done, so that the spectra of the frequency domain delay line stay consecutive
+#define CONV_MAXLATE 2
+
+namespace BobDSPLadspa
+{
+  //one level of uniform partitions, the input spectra of the last blocks are kept in a frequency domain delay line,
+  //and multiplied with the spectra of the partitions
+  class CConvolverLevel
+  {
+    public:
+      //rtpriority is the realtime priority of the thread that calls Process(), or -1
+      CConvolverLevel(CImpulse* impulse, int level, bool threaded, int rtpriority);
+      ~CConvolverLevel();
+
+      //stores the input samples, and adds the output of this level to out
+      //samples must not cross a block boundary, when wait is false the realtime thread
+      //doesn't wait for a late job, the previous output block is repeated instead
+      void Process(const float* in, float* out, int samples, bool wait);
+
+      //returns the number of late jobs since the last call
+      int  TakeLate();
+
+    private:
+      void         Calculate(const float* in, float* out);
+      static void* ThreadFunction(void* arg);
+
+      CImpulse*     m_impulse;
+      int           m_level;
+      int           m_blocksize;
+      int           m_partitions;
+      int           m_stride;
+      CFFT          m_fft;
+      int           m_pos;
+
+      float*        m_input;     //previous block and current block
+      float*        m_fdlre;     //spectra of the input of the last m_partitions blocks
+      float*        m_fdlim;
+      int           m_fdlpos;
+      float*        m_accre;
+      float*        m_accim;
+      float*        m_time;
+      float*        m_result[2]; //output of the current block, and output of the job running in the thread
+      int           m_current;
+
+      bool          m_threaded;
+      pthread_t     m_thread;
+      sem_t         m_start;
+      sem_t         m_done;
+      bool          m_busy;
+      volatile bool m_stop;
+      float*        m_jobinput;  //the input of m_jobblocks consecutive blocks, and the block before them
+      int           m_jobblocks;
+      bool          m_jobreset;  //clear the frequency domain delay line before the job
+      float*        m_backlog;   //input of the blocks that were missed while a job was late
+      int           m_missed;
+      bool          m_lost;      //more than CONV_MAXLATE blocks were missed
+      int           m_late;
+  };
+
+  //convolves with an impulse response without latency, the head of the impulse response is
+  //convolved directly, the rest with partition levels of increasing block size
+  class CConvolverEngine
+  {
+    public:
+      //impulse may be NULL, then the output is equal to the input,
+      //rtpriority is the realtime priority of the thread that calls Process(), or -1
+      CConvolverEngine(CImpulse* impulse, int rtpriority);
+      ~CConvolverEngine();
+
+      bool IsEmpty() { return m_impulse == NULL; }
+
+      //in may be the same buffer as out, wait is passed to CConvolverLevel::Process()
+      void Process(const float* in, float* out, int samples, bool wait);
+
+      //returns the number of late jobs of all levels since the last call
+      int  TakeLate();
+
+    private:
+      void ProcessHead(float* out, int samples);
+
+      CImpulse*        m_impulse;
+      float*           m_input; //previous head block and current head block
+      int              m_pos;
+      CConvolverLevel* m_levels[CONV_LEVELS];
+  };
+}
+
+#endif //CONVOLVERENGINE_H
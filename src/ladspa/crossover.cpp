@@ -0,0 +1,307 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "crossover.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+//q factors of the butterworth sections, a linkwitz-riley filter is a butterworth filter applied twice
+static const double g_lr4q[] = { M_SQRT1_2 };
+static const double g_lr8q[] = { 0.54119610014619690, 1.30656296487637660 };
+
+CCrossover::CCrossover(unsigned long samplerate)
+{
+  m_samplerate  = samplerate;
+  m_initialized = false;
+  m_bands       = 2;
+  m_nrsections  = 0;
+  memset(m_ports, 0, sizeof(m_ports));
+  memset(m_oldsettings, 0, sizeof(m_oldsettings));
+  memset(m_coefs, 0, sizeof(m_coefs));
+  memset(m_state, 0, sizeof(m_state));
+}
+
+CCrossover::~CCrossover()
+{
+}
+
+void CCrossover::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CCrossover::Activate()
+{
+  memset(m_state, 0, sizeof(m_state));
+}
+
+void CCrossover::Deactivate()
+{
+}
+
+//b and a are normalized to a0, with a in the usual sign, y = b0x + b1x1 + b2x2 - a1y1 - a2y2
+void CCrossover::SetSection(int section, int lane, const double* b, const double* a)
+{
+  m_coefs[section][0][lane] = b[0];
+  m_coefs[section][1][lane] = b[1];
+  m_coefs[section][2][lane] = b[2];
+  m_coefs[section][3][lane] = -a[0];
+  m_coefs[section][4][lane] = -a[1];
+}
+
+void CCrossover::UpdateCoefs()
+{
+  //only calculate the coefficients if the parameters changed
+  bool changed = false;
+  for (int i = 0; i < XO_SETTINGS; i++)
+  {
+    if (m_oldsettings[i] != *m_ports[XO_BANDS + i])
+    {
+      changed = true;
+      m_oldsettings[i] = *m_ports[XO_BANDS + i];
+    }
+  }
+
+  if (!changed && m_initialized)
+    return;
+
+  m_initialized = true;
+
+  int  bands      = Clamp(Round32(*m_ports[XO_BANDS]), 2, XO_MAXBANDS);
+  int  type       = Clamp(Round32(*m_ports[XO_TYPE]), (int)XO_LR2, (int)XO_NUMTYPES - 1);
+  bool compensate = *m_ports[XO_COMPENSATE] > 0.5f;
+
+  //a lowpass or highpass is 1, 2 or 4 biquads, the allpass that has the same phase is 1 or 2 biquads
+  int sections   = type == XO_LR2 ? 1 : (type == XO_LR4 ? 2 : 4);
+  int apsections = type == XO_LR8 ? 2 : 1;
+
+  //when the number of bands or the type changes, the filters in the lanes are different filters
+  if (bands != m_bands || sections * (bands - 1) != m_nrsections)
+    memset(m_state, 0, sizeof(m_state));
+
+  m_bands      = bands;
+  m_nrsections = sections * (bands - 1);
+
+  for (int xover = 0; xover < bands - 1; xover++)
+  {
+    double freq = Clamp(*m_ports[XO_FREQ1 + xover], 1.0f, m_samplerate * 0.49f);
+    double K    = tan(M_PI * freq / m_samplerate);
+
+    for (int lane = 0; lane < XO_LANES; lane++)
+    {
+      for (int s = 0; s < sections; s++)
+      {
+        int    section = xover * sections + s;
+        double b[3]    = { 1.0, 0.0, 0.0 };
+        double a[2]    = { 0.0, 0.0 };
+
+        //bands above the crossover get a highpass, the band below it a lowpass
+        //lower bands get an allpass when compensating, unused lanes pass their input
+        bool highpass = lane > xover && lane < bands;
+        bool lowpass  = lane == xover;
+        bool allpass  = lane < xover && compensate && s < apsections;
+
+        if (type == XO_LR2)
+        {
+          //LR2 is a first order butterworth filter applied twice, the highpass is inverted
+          //so that the sum of both bands is the first order allpass
+          double p = (K - 1.0) / (K + 1.0);
+          if (lowpass || highpass)
+          {
+            double g = (lowpass ? K : 1.0) / (K + 1.0);
+            b[0] = g * g;
+            b[1] = (lowpass ? 2.0 : -2.0) * g * g;
+            b[2] = g * g;
+            if (highpass)
+            {
+              b[0] = -b[0];
+              b[1] = -b[1];
+              b[2] = -b[2];
+            }
+            a[0] = 2.0 * p;
+            a[1] = p * p;
+          }
+          else if (allpass)
+          {
+            b[0] = p;
+            b[1] = 1.0;
+            a[0] = p;
+          }
+        }
+        else
+        {
+          //butterworth sections, the same section is used twice for the lowpass and highpass
+          //the allpass uses every section once
+          double q    = type == XO_LR4 ? g_lr4q[0] : g_lr8q[lowpass || highpass ? s / 2 : s];
+          double norm = 1.0 / (1.0 + K / q + K * K);
+          if (lowpass || highpass || allpass)
+          {
+            a[0] = 2.0 * (K * K - 1.0) * norm;
+            a[1] = (1.0 - K / q + K * K) * norm;
+          }
+
+          if (lowpass)
+          {
+            b[0] = K * K * norm;
+            b[1] = 2.0 * b[0];
+            b[2] = b[0];
+          }
+          else if (highpass)
+          {
+            b[0] = norm;
+            b[1] = -2.0 * b[0];
+            b[2] = b[0];
+          }
+          else if (allpass)
+          {
+            b[0] = a[1];
+            b[1] = a[0];
+            b[2] = 1.0;
+          }
+        }
+
+        SetSection(section, lane, b, a);
+      }
+    }
+  }
+}
+
+void CCrossover::Run(unsigned long samplecount)
+{
+  UpdateCoefs();
+
+  float* out[XO_LANES];
+  for (int lane = 0; lane < XO_LANES; lane++)
+    out[lane] = m_ports[XO_OUT1 + lane];
+
+  //outputs of bands that are not used are silent
+  for (int lane = m_bands; lane < XO_LANES; lane++)
+    memset(out[lane], 0, samplecount * sizeof(float));
+
+  //read the input once for all bands
+  for (unsigned long i = 0; i < samplecount; i += XO_BLOCK)
+  {
+    int samples = Min((int)(samplecount - i), XO_BLOCK);
+    float* blockout[XO_LANES];
+    for (int lane = 0; lane < XO_LANES; lane++)
+      blockout[lane] = out[lane] + i;
+
+    RunSections(m_ports[XO_IN] + i, blockout, samples);
+  }
+}
+
+//every section runs over the whole block while its coefficients and state are kept in registers
+void OPTIMIZE CCrossover::RunSections(const float* in, float* const* out, int samples)
+{
+#ifdef USE_SSE
+  __m128 buf[XO_BLOCK];
+  for (int i = 0; i < samples; i++)
+    buf[i] = _mm_set1_ps(in[i]);
+
+  for (int section = 0; section < m_nrsections; section++)
+  {
+    __m128 b0 = _mm_loadu_ps(m_coefs[section][0]);
+    __m128 b1 = _mm_loadu_ps(m_coefs[section][1]);
+    __m128 b2 = _mm_loadu_ps(m_coefs[section][2]);
+    __m128 a1 = _mm_loadu_ps(m_coefs[section][3]);
+    __m128 a2 = _mm_loadu_ps(m_coefs[section][4]);
+    __m128 s1 = _mm_loadu_ps(m_state[section][0]);
+    __m128 s2 = _mm_loadu_ps(m_state[section][1]);
+
+    for (int i = 0; i < samples; i++)
+    {
+      __m128 x = buf[i];
+      __m128 y = _mm_add_ps(_mm_mul_ps(b0, x), s1);
+      s1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b1, x), _mm_mul_ps(a1, y)), s2);
+      s2 = _mm_add_ps(_mm_mul_ps(b2, x), _mm_mul_ps(a2, y));
+      buf[i] = y;
+    }
+
+    _mm_storeu_ps(m_state[section][0], s1);
+    _mm_storeu_ps(m_state[section][1], s2);
+  }
+
+  //transpose 4 samples of 4 bands to 4 samples of every band
+  int i = 0;
+  if (m_bands == XO_LANES)
+  {
+    for (; i + 3 < samples; i += 4)
+    {
+      __m128 r0 = buf[i];
+      __m128 r1 = buf[i + 1];
+      __m128 r2 = buf[i + 2];
+      __m128 r3 = buf[i + 3];
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _mm_storeu_ps(out[0] + i, r0);
+      _mm_storeu_ps(out[1] + i, r1);
+      _mm_storeu_ps(out[2] + i, r2);
+      _mm_storeu_ps(out[3] + i, r3);
+    }
+  }
+
+  for (; i < samples; i++)
+  {
+    ssevec y;
+    y.v = buf[i];
+    for (int lane = 0; lane < m_bands; lane++)
+      out[lane][i] = y.f[lane];
+  }
+#else
+  float buf[XO_BLOCK][XO_LANES];
+  for (int i = 0; i < samples; i++)
+  {
+    for (int lane = 0; lane < XO_LANES; lane++)
+      buf[i][lane] = in[i];
+  }
+
+  for (int section = 0; section < m_nrsections; section++)
+  {
+    for (int lane = 0; lane < XO_LANES; lane++)
+    {
+      float b0 = m_coefs[section][0][lane];
+      float b1 = m_coefs[section][1][lane];
+      float b2 = m_coefs[section][2][lane];
+      float a1 = m_coefs[section][3][lane];
+      float a2 = m_coefs[section][4][lane];
+      float s1 = m_state[section][0][lane];
+      float s2 = m_state[section][1][lane];
+
+      for (int i = 0; i < samples; i++)
+      {
+        float x = buf[i][lane];
+        float y = b0 * x + s1;
+        s1 = b1 * x + a1 * y + s2;
+        s2 = b2 * x + a2 * y;
+        buf[i][lane] = y;
+      }
+
+      m_state[section][0][lane] = s1;
+      m_state[section][1][lane] = s2;
+    }
+  }
+
+  for (int i = 0; i < samples; i++)
+  {
+    for (int lane = 0; lane < m_bands; lane++)
+      out[lane][i] = buf[i][lane];
+  }
+#endif
+}
@@ -0,0 +1,91 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef CROSSOVER_H
+#define CROSSOVER_H
+
+#include "config.h"
+#include "util/ssedefs.h"
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+
+#define XO_IN          0
+#define XO_OUT1        1
+#define XO_BANDS       5
+#define XO_TYPE        6
+#define XO_FREQ1       7
+#define XO_COMPENSATE  10
+#define XO_NUMPORTS    11
+
+#define XO_MAXBANDS    4
+#define XO_LANES       4
+#define XO_SETTINGS    (XO_NUMPORTS - XO_BANDS)
+
+//linkwitz-riley crossover types, LR8 needs 4 biquads per crossover frequency
+enum EXOTYPE
+{
+  XO_LR2,
+  XO_LR4,
+  XO_LR8,
+  XO_NUMTYPES
+};
+
+#define XO_MAXSECTIONS ((XO_MAXBANDS - 1) * 4)
+
+//number of samples processed per pass through the sections
+#define XO_BLOCK 256
+
+namespace BobDSPLadspa
+{
+  //splits the input into up to 4 bands, every band runs in a lane of an sse vector,
+  //and is the input filtered by a cascade of a highpass for every crossover frequency
+  //below the band, a lowpass for the crossover frequency above it, and when phase
+  //compensation is enabled, an allpass for every higher crossover frequency,
+  //so that the sum of all bands is an allpass filter
+  class CCrossover : public IFilter
+  {
+    public:
+      CCrossover(unsigned long samplerate);
+      ~CCrossover();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+
+    private:
+      void UpdateCoefs();
+      void SetSection(int section, int lane, const double* b, const double* a);
+      void RunSections(const float* in, float* const* out, int samples);
+
+      float        m_samplerate;
+      LADSPA_Data* m_ports[XO_NUMPORTS];
+      LADSPA_Data  m_oldsettings[XO_SETTINGS];
+      bool         m_initialized;
+      int          m_bands;
+      int          m_nrsections;
+
+      //b0, b1, b2, a1 and a2 of every lane, the a coefficients are negated, like in CBiquadCoef
+      float        m_coefs[XO_MAXSECTIONS][5][XO_LANES];
+
+      //transposed direct form II state
+      float        m_state[XO_MAXSECTIONS][2][XO_LANES];
+  };
+}
+
+#endif //CROSSOVER_H
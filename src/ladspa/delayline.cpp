@@ -0,0 +1,257 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "delayline.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+//aligned_alloc needs a size that's a multiple of the alignment
+static float* AllocFloats(int size)
+{
+  float* buf = (float*)aligned_alloc(ALIGN, ((size * sizeof(float) + ALIGN - 1) / ALIGN) * ALIGN);
+  memset(buf, 0, size * sizeof(float));
+  return buf;
+}
+
+CDelayLine::CDelayLine(int channels, int maxdelay, int samplerate)
+{
+  m_channels     = channels;
+  m_maxdelay     = Max(maxdelay, 0);
+  m_glidesamples = Max(Round32(samplerate * DELAY_GLIDETIME), 1);
+
+  //room for the longest delay, a block, and the sample before the delay the allpass filter needs
+  m_size = 1;
+  while (m_size < m_maxdelay + DELAY_BLOCK + 2)
+    m_size *= 2;
+  m_mask = m_size - 1;
+
+  m_rings = new float*[m_channels];
+  for (int channel = 0; channel < m_channels; channel++)
+    m_rings[channel] = AllocFloats(m_size);
+
+  m_delay  = new float[m_channels];
+  m_target = new float[m_channels];
+  m_step   = new float[m_channels];
+  m_last   = new float[m_channels];
+
+  m_scratch = AllocFloats(DELAY_BLOCK + 1);
+
+  Reset();
+}
+
+CDelayLine::~CDelayLine()
+{
+  for (int channel = 0; channel < m_channels; channel++)
+    free(m_rings[channel]);
+
+  delete[] m_rings;
+  delete[] m_delay;
+  delete[] m_target;
+  delete[] m_step;
+  delete[] m_last;
+  free(m_scratch);
+}
+
+void CDelayLine::Reset()
+{
+  Clear();
+
+  for (int channel = 0; channel < m_channels; channel++)
+  {
+    m_delay[channel]  = 0.0f;
+    m_target[channel] = 0.0f;
+    m_step[channel]   = 0.0f;
+  }
+
+  m_jump = true;
+}
+
+void CDelayLine::Clear()
+{
+  for (int channel = 0; channel < m_channels; channel++)
+  {
+    memset(m_rings[channel], 0, m_size * sizeof(float));
+    m_last[channel] = 0.0f;
+  }
+
+  m_writepos = 0;
+}
+
+void CDelayLine::SetDelay(int channel, float delay)
+{
+  delay = Clamp(delay, 0.0f, (float)m_maxdelay);
+
+  if (m_jump)
+  {
+    m_delay[channel]  = delay;
+    m_target[channel] = delay;
+    m_step[channel]   = 0.0f;
+  }
+  else if (delay != m_target[channel])
+  {
+    m_target[channel] = delay;
+    m_step[channel]   = (delay - m_delay[channel]) / m_glidesamples;
+  }
+}
+
+bool CDelayLine::IsZero()
+{
+  for (int channel = 0; channel < m_channels; channel++)
+  {
+    if (m_delay[channel] != 0.0f || m_target[channel] != 0.0f)
+      return false;
+  }
+
+  return true;
+}
+
+void CDelayLine::Process(const float* const* in, float* const* out, int samples)
+{
+  m_jump = false;
+
+  for (int offset = 0; offset < samples; offset += DELAY_BLOCK)
+  {
+    int block = Min(samples - offset, DELAY_BLOCK);
+    for (int channel = 0; channel < m_channels; channel++)
+      ProcessChannel(channel, in[channel] + offset, out[channel] + offset, block);
+
+    m_writepos = (m_writepos + block) & m_mask;
+  }
+}
+
+//copies samples from the ring buffer starting at pos, which may be negative, with at most two memcpy's
+void CDelayLine::ReadRing(float* ring, int pos, float* out, int samples)
+{
+  pos &= m_mask;
+  int first = Min(samples, m_size - pos);
+  memcpy(out, ring + pos, first * sizeof(float));
+  memcpy(out + first, ring, (samples - first) * sizeof(float));
+}
+
+//splits a delay into a whole number of samples, and the fraction the allpass filter
+//y[n] = coef * x[n] + x[n - 1] - coef * y[n - 1] delays x by, which is kept between 0.5 and 1.5
+//where the filter is most accurate, delays shorter than 0.5 samples use a fraction below 0.5
+void CDelayLine::GetAllpass(float delay, int& whole, float& coef)
+{
+  whole = Max((int)(delay - 0.5f), 0);
+  float fraction = delay - whole;
+  coef = (1.0f - fraction) / (1.0f + fraction);
+}
+
+void OPTIMIZE CDelayLine::ProcessChannel(int channel, const float* in, float* out, int samples)
+{
+  //write the input into the ring buffer first, so that the output can be the same buffer
+  float* ring  = m_rings[channel];
+  int    first = Min(samples, m_size - m_writepos);
+  memcpy(ring + m_writepos, in, first * sizeof(float));
+  memcpy(ring, in + first, (samples - first) * sizeof(float));
+
+  float delay = m_delay[channel];
+  float step  = m_step[channel];
+  float y     = m_last[channel];
+  int   whole;
+  float coef;
+
+  if (step == 0.0f)
+  {
+    //a whole sample delay is only a copy
+    whole = (int)delay;
+    if (delay == (float)whole)
+    {
+      ReadRing(ring, m_writepos - whole, out, samples);
+      m_last[channel] = out[samples - 1];
+      return;
+    }
+
+    GetAllpass(delay, whole, coef);
+
+    //m_scratch[i + 1] is x[n] for output sample i, m_scratch[i] is x[n - 1]
+    const float* s = m_scratch;
+    ReadRing(ring, m_writepos - whole - 1, m_scratch, samples + 1);
+
+    int i = 0;
+#ifdef USE_SSE
+    //like the block kernel of CBiquad, 4 output samples are the sum of the columns of a matrix
+    //multiplied with b[n] = coef * x[n] + x[n - 1] of those samples, and with y[n - 1]
+    float  p1   = -coef;
+    float  p2   = p1 * p1;
+    float  p3   = p2 * p1;
+    __m128 col0  = _mm_setr_ps(1.0f, p1, p2, p3);
+    __m128 col1  = _mm_setr_ps(0.0f, 1.0f, p1, p2);
+    __m128 col2  = _mm_setr_ps(0.0f, 0.0f, 1.0f, p1);
+    __m128 col3  = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+    __m128 coly  = _mm_setr_ps(p1, p2, p3, p2 * p2);
+    __m128 coefs = _mm_set1_ps(coef);
+    __m128 yd    = _mm_set1_ps(y);
+
+    for (; i + 3 < samples; i += 4)
+    {
+      __m128 b = _mm_add_ps(_mm_mul_ps(coefs, _mm_loadu_ps(s + i + 1)), _mm_loadu_ps(s + i));
+
+      __m128 sum0 = _mm_add_ps(_mm_mul_ps(col0, _mm_shuffle_ps(b, b, 0x00)),
+                               _mm_mul_ps(col1, _mm_shuffle_ps(b, b, 0x55)));
+      __m128 sum1 = _mm_add_ps(_mm_mul_ps(col2, _mm_shuffle_ps(b, b, 0xAA)),
+                               _mm_mul_ps(col3, _mm_shuffle_ps(b, b, 0xFF)));
+      __m128 yv   = _mm_add_ps(_mm_add_ps(sum0, sum1), _mm_mul_ps(coly, yd));
+
+      _mm_storeu_ps(out + i, yv);
+      yd = _mm_shuffle_ps(yv, yv, 0xFF);
+    }
+
+    y = _mm_cvtss_f32(yd);
+#endif
+    for (; i < samples; i++)
+    {
+      y      = coef * (s[i + 1] - y) + s[i];
+      out[i] = y;
+    }
+
+    m_last[channel] = y;
+    return;
+  }
+
+  //gliding, the delay and the filter change every sample until it reaches the target
+  float target = m_target[channel];
+  float low    = Min(delay, target);
+  float high   = Max(delay, target);
+
+  for (int i = 0; i < samples; i++)
+  {
+    GetAllpass(Clamp(delay + step * i, low, high), whole, coef);
+
+    int pos = m_writepos + i - whole;
+    y       = coef * (ring[pos & m_mask] - y) + ring[(pos - 1) & m_mask];
+    out[i]  = y;
+  }
+
+  m_last[channel] = y;
+
+  float next = delay + step * samples;
+  if ((step > 0.0f && next >= target) || (step < 0.0f && next <= target) || next == delay)
+  {
+    m_delay[channel] = target;
+    m_step[channel]  = 0.0f;
+  }
+  else
+  {
+    m_delay[channel] = next;
+  }
+}
@@ -0,0 +1,84 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef DELAYLINE_H
+#define DELAYLINE_H
+
+#include "util/ssedefs.h"
+
+//number of samples processed per channel at a time
+#define DELAY_BLOCK     256
+
+//when the delay changes, it glides linearly to the new delay in this time
+#define DELAY_GLIDETIME 0.05f
+
+namespace BobDSPLadspa
+{
+  //multichannel delay line with fractional delays
+  //
+  //every block the input is copied into a ring buffer, and the output is copied from it with
+  //at most two memcpy's, fractional delays are interpolated with a first order thiran allpass filter,
+  //its gain is 1 at every frequency, and it only needs the two samples around the delay,
+  //so every delay down to 0 samples is kept without adding latency,
+  //when the delay changes it glides to the new delay, with the filter calculated every sample
+  class CDelayLine
+  {
+    public:
+      //maxdelay is in samples
+      CDelayLine(int channels, int maxdelay, int samplerate);
+      ~CDelayLine();
+
+      //clears the ring buffers, the next delays are applied without a glide
+      void Reset();
+
+      //only clears the ring buffers
+      void Clear();
+
+      //delay is in samples, and is clamped to the maximum delay
+      void SetDelay(int channel, float delay);
+
+      //true when every delay is 0, and none of them is gliding
+      bool IsZero();
+
+      //in and out have a buffer for every channel, an output buffer may be the same as its input buffer
+      void Process(const float* const* in, float* const* out, int samples);
+
+    private:
+      void ProcessChannel(int channel, const float* in, float* out, int samples);
+      void ReadRing(float* ring, int pos, float* out, int samples);
+      static void GetAllpass(float delay, int& whole, float& coef);
+
+      int     m_channels;
+      int     m_maxdelay;
+      int     m_glidesamples;
+      int     m_size; //ring buffer size, a power of two
+      int     m_mask;
+      int     m_writepos;
+      bool    m_jump;
+
+      float** m_rings;
+      float*  m_delay;  //current delay of every channel
+      float*  m_target; //delay every channel glides to
+      float*  m_step;   //change of the delay per sample while gliding
+      float*  m_last;   //last output sample of every channel, the state of the allpass filter
+
+      float*  m_scratch; //linear copy of the part of a ring buffer that's interpolated
+  };
+}
+
+#endif //DELAYLINE_H
@@ -16,6 +16,7 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include "distancedelay.h"
 #include "util/misc.h"
 
@@ -24,24 +25,16 @@ using namespace BobDSPLadspa;
 #define SPEED_OF_SOUND 343.0 //speed of sound in m/s
 #define MAX_DISTANCE   100.0 //max distance delay that can be added
 
-CDistanceDelay::CDistanceDelay(unsigned long samplerate) : m_ports {}
+CDistanceDelay::CDistanceDelay(unsigned long samplerate) :
+  m_ports {},
+  m_delayline(DISTANCECHANNELS, ceil(MAX_DISTANCE / SPEED_OF_SOUND * samplerate), samplerate)
 {
-  m_samplerate   = samplerate;
-  m_delaybufsize = Round32(MAX_DISTANCE / SPEED_OF_SOUND * samplerate);
-  m_delaybufpos  = 0;
-
-  //allocate buffers for the maximum delay
-  for (int i = 0; i < DISTANCECHANNELS; i++)
-  {
-    m_delaybuf[i] = new LADSPA_Data[m_delaybufsize];
-    memset(m_delaybuf[i], 0, m_delaybufsize * sizeof(LADSPA_Data));
-  }
+  m_samplerate = samplerate;
+  m_elided     = false;
 }
 
 CDistanceDelay::~CDistanceDelay()
 {
-  for (int i = 0; i < DISTANCECHANNELS; i++)
-    delete[] m_delaybuf[i];
 }
 
 void CDistanceDelay::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
@@ -51,55 +44,55 @@ void CDistanceDelay::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
 
 void CDistanceDelay::Activate()
 {
+  m_delayline.Reset();
 }
 
 void CDistanceDelay::Run(unsigned long samplecount)
 {
-  //the settings ports set the delay in meters, calculate how many samples
-  //to delay based on the speed of sound and the sample rate
-  int delays[DISTANCECHANNELS] = {};
-  for (int c = 0; c < DISTANCECHANNELS; c++)
+  //when the host skipped running this instance, the delay buffers hold old audio
+  //clear them so that it doesn't come out when the delay is increased again
+  if (m_elided)
   {
-    delays[c] = Round32(Clamp(*m_ports[c + DISTANCECHANNELS * 2], 0.0, MAX_DISTANCE) /
-                        SPEED_OF_SOUND * m_samplerate);
-
-    if (delays[c] >= m_delaybufsize)
-      delays[c] = m_delaybufsize - 1;
-    if (delays[c] < 0)
-      delays[c] = 0;
+    m_delayline.Clear();
+    m_elided = false;
   }
 
-  //calculate where in the delay buffer to write and read samples
-  int writepos = m_delaybufpos;
-  int readpos[DISTANCECHANNELS] = {};
+  SetDelays();
+
+  const float* in[DISTANCECHANNELS];
+  float*       out[DISTANCECHANNELS];
   for (int c = 0; c < DISTANCECHANNELS; c++)
   {
-    readpos[c] = m_delaybufpos - delays[c];
-    if (readpos[c] < 0)
-      readpos[c] += m_delaybufsize;
+    in[c]  = m_ports[c];
+    out[c] = m_ports[c + DISTANCECHANNELS];
   }
 
-  //write samples to the delay buffer, and read them back at a delayed position
-  for (unsigned long i = 0; i < samplecount; i++)
-  {
-    for (int c = 0; c < DISTANCECHANNELS; c++)
-    {
-      m_delaybuf[c][writepos] = m_ports[c][i];
-      m_ports[c + DISTANCECHANNELS][i] = m_delaybuf[c][readpos[c]];
+  m_delayline.Process(in, out, samplecount);
+}
 
-      readpos[c]++;
-      if (readpos[c] >= m_delaybufsize)
-        readpos[c] = 0;
-    }
+void CDistanceDelay::Deactivate()
+{
+}
 
-    writepos++;
-    if (writepos >= m_delaybufsize)
-      writepos = 0;
-  }
+bool CDistanceDelay::IsIdentity()
+{
+  //a delay that changes to or from 0 glides, this is only an identity when it's done
+  SetDelays();
+  return m_delayline.IsZero();
+}
 
-  m_delaybufpos = writepos;
+void CDistanceDelay::Skipped()
+{
+  m_elided = true;
 }
 
-void CDistanceDelay::Deactivate()
+void CDistanceDelay::SetDelays()
 {
+  //the settings ports set the delay in meters, calculate the delay in samples
+  //based on the speed of sound and the sample rate, fractions of a sample are interpolated
+  for (int c = 0; c < DISTANCECHANNELS; c++)
+  {
+    double distance = Clamp(*m_ports[c + DISTANCECHANNELS * 2], 0.0, MAX_DISTANCE);
+    m_delayline.SetDelay(c, distance / SPEED_OF_SOUND * m_samplerate);
+  }
 }
@@ -21,6 +21,7 @@
 
 #include "filterdescriptions.h"
 #include "filterinterface.h"
+#include "delayline.h"
 
 #define DISTANCECHANNELS 2
 
@@ -36,13 +37,16 @@ namespace BobDSPLadspa
       void Activate();
       void Run(unsigned long samplecount);
       void Deactivate();
+      bool IsIdentity();
+      void Skipped();
 
     private:
+      void         SetDelays();
+
       LADSPA_Data  m_samplerate;
       LADSPA_Data* m_ports[6];
-      LADSPA_Data* m_delaybuf[DISTANCECHANNELS];
-      int          m_delaybufsize;
-      int          m_delaybufpos;
+      CDelayLine   m_delayline;
+      bool         m_elided;
   };
 }
 #endif //DISTANCEDELAY_H
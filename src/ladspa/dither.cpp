@@ -16,24 +16,45 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <math.h>
 #include <string.h>
 #include <stdlib.h>
 #include <sys/time.h>
 #include "dither.h"
 #include "util/misc.h"
-#include "util/inclstdint.h"
-#include "util/ssedefs.h"
 
 using namespace BobDSPLadspa;
 
+//coefficients of the error feedback filters, the noise transfer function is 1 - sum(h[k] * z^-(k + 1))
+//the lipshitz and f-weighted filters are designed for 44.1 KHz, from Lipshitz, Vanderkooy and
+//Wannamaker, "Minimally audible noise shaping", JAES 1991
+static const int    g_taps[DITHER_NUMSHAPES] = { 0, 1, 2, 5, 9 };
+static const double g_shapes[DITHER_NUMSHAPES][DITHER_MAXTAPS] =
+{
+  { },
+  { 1.0 },
+  { 2.0, -1.0 },
+  { 2.033, -2.165, 1.959, -1.590, 0.6149 },
+  { 2.412, -3.370, 3.937, -4.174, 3.353, -2.205, 1.281, -0.569, 0.0847 }
+};
+
 CDither::CDither()
 {
   memset(m_ports, 0, sizeof(m_ports));
 
-  //use seconds and microseconds of gettimeofday as seed for rand_r
+  //use seconds and microseconds of gettimeofday as seed, every lane gets a different seed,
+  //a xorshift generator gets stuck at 0, so make sure it's never 0
   struct timeval tv;
   gettimeofday(&tv, NULL);
-  m_rand = tv.tv_sec + tv.tv_usec;
+  uint32_t seed = tv.tv_sec + tv.tv_usec;
+  for (int i = 0; i < 4; i++)
+  {
+    seed = seed * 1664525 + 1013904223;
+    m_state[i] = seed ? seed : 1;
+  }
+
+  m_shape = DITHER_NONE;
+  Activate();
 }
 
 CDither::~CDither()
@@ -47,25 +68,123 @@ void CDither::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
 
 void CDither::Activate()
 {
+  memset(m_error, 0, sizeof(m_error));
+  m_errorpos = 0;
 }
 
 void OPTIMIZE CDither::Run(unsigned long samplecount)
 {
-  LADSPA_Data* in    = m_ports[0];
-  LADSPA_Data* inend = m_ports[0] + samplecount;
-  LADSPA_Data* out   = m_ports[1];
-
-  LADSPA_Data precision = powf(2.0f, Round32(Clamp(*(m_ports[2]), 1.0f, 32.0f)) - 1.0f);
-
-  //add one bit noise twice to each sample, this will add noise with triangular distribution
-  //when the samples are converted to integer of the set bitdepth for playback on the soundcard,
-  //the noise will dither the audio
-  while (in != inend)
-    *(out++) = *(in++) + ((LADSPA_Data)rand_r(&m_rand) / RAND_MAX +
-               (LADSPA_Data)rand_r(&m_rand) / RAND_MAX - 1.0f) / precision;
+  int shape = Clamp(Round32(*m_ports[DITHER_SHAPING]), (int)DITHER_NONE, (int)DITHER_NUMSHAPES - 1);
+  if (shape != m_shape)
+  {
+    m_shape = shape;
+    Activate();
+  }
+
+  double precision = pow(2.0, Round32(Clamp(*m_ports[DITHER_BITDEPTH], 1.0f, 32.0f)) - 1.0);
+  float  lsb       = 1.0 / precision;
+
+  float noise[DITHER_BLOCK] __attribute__((aligned(ALIGN)));
+  for (unsigned long offset = 0; offset < samplecount; offset += DITHER_BLOCK)
+  {
+    int          samples = Min((int)(samplecount - offset), DITHER_BLOCK);
+    LADSPA_Data* in      = m_ports[DITHER_IN] + offset;
+    LADSPA_Data* out     = m_ports[DITHER_OUT] + offset;
+
+    MakeNoise(noise, samples);
+
+    if (m_shape == DITHER_NONE)
+    {
+      //add the triangular noise, when the samples are converted to integer of the set bitdepth
+      //for playback on the soundcard, the noise will dither the audio
+      int i = 0;
+#ifdef USE_SSE
+      __m128 lsbvec = _mm_set1_ps(lsb);
+      for (; i + 3 < samples; i += 4)
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_loadu_ps(in + i), _mm_mul_ps(_mm_load_ps(noise + i), lsbvec)));
+#endif
+      for (; i < samples; i++)
+        out[i] = in[i] + noise[i] * lsb;
+    }
+    else
+    {
+      RunShaped(in, out, noise, samples, precision);
+    }
+  }
 }
 
-void CDither::Deactivate()
+//makes triangular noise between -1 and 1, the difference of two uniform values
+//noise is made for a multiple of 4 samples
+void OPTIMIZE CDither::MakeNoise(float* noise, int samples)
+{
+#if defined(USE_SSE) && defined(__SSE2__)
+  __m128i state = _mm_loadu_si128((__m128i*)m_state);
+  __m128  scale = _mm_set1_ps(1.0f / 16777216.0f);
+
+  for (int i = 0; i < samples; i += 4)
+  {
+    //xorshift32 in every lane, the upper 24 bits are converted to float exactly
+    __m128 uniform[2];
+    for (int j = 0; j < 2; j++)
+    {
+      state = _mm_xor_si128(state, _mm_slli_epi32(state, 13));
+      state = _mm_xor_si128(state, _mm_srli_epi32(state, 17));
+      state = _mm_xor_si128(state, _mm_slli_epi32(state, 5));
+      uniform[j] = _mm_cvtepi32_ps(_mm_srli_epi32(state, 8));
+    }
+
+    _mm_store_ps(noise + i, _mm_mul_ps(_mm_sub_ps(uniform[0], uniform[1]), scale));
+  }
+
+  _mm_storeu_si128((__m128i*)m_state, state);
+#else
+  for (int i = 0; i < samples; i += 4)
+  {
+    for (int lane = 0; lane < 4; lane++)
+    {
+      float uniform[2];
+      for (int j = 0; j < 2; j++)
+      {
+        uint32_t state = m_state[lane];
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        m_state[lane] = state;
+        uniform[j] = (float)(state >> 8);
+      }
+
+      noise[i + lane] = (uniform[0] - uniform[1]) * (1.0f / 16777216.0f);
+    }
+  }
+#endif
+}
+
+//the error feedback is a recursion over the samples, so this runs one sample at a time,
+//in double so that the error is accurate at high bit depths too
+void CDither::RunShaped(const float* in, float* out, const float* noise, int samples, double precision)
 {
+  const double* h    = g_shapes[m_shape];
+  int           taps = g_taps[m_shape];
+  double        lsb  = 1.0 / precision;
+
+  for (int i = 0; i < samples; i++)
+  {
+    //m_error[m_errorpos] is the error of the previous sample
+    const double* error = m_error + m_errorpos;
+    double feedback = 0.0;
+    for (int k = 0; k < taps; k++)
+      feedback += h[k] * error[k];
+
+    double value     = in[i] * precision - feedback;
+    double quantized = floor(value + noise[i] + 0.5);
+
+    m_errorpos = m_errorpos == 0 ? DITHER_MAXTAPS - 1 : m_errorpos - 1;
+    m_error[m_errorpos] = m_error[m_errorpos + DITHER_MAXTAPS] = quantized - value;
+
+    out[i] = quantized * lsb;
+  }
 }
 
+void CDither::Deactivate()
+{
+}
@@ -19,11 +19,37 @@
 #ifndef DITHER_H
 #define DITHER_H
 
+#include "util/inclstdint.h"
+#include "util/ssedefs.h"
 #include "filterdescriptions.h"
 #include "filterinterface.h"
 
+#define DITHER_IN        0
+#define DITHER_OUT       1
+#define DITHER_BITDEPTH  2
+#define DITHER_SHAPING   3
+#define DITHER_NUMPORTS  4
+
+//noise for this many samples is made at a time
+#define DITHER_BLOCK     256
+#define DITHER_MAXTAPS   9
+
+enum EDITHERSHAPE
+{
+  DITHER_NONE,       //triangular noise is added, the host quantizes
+  DITHER_FIRSTORDER, //quantized here, the error is fed back with these filters
+  DITHER_SECONDORDER,
+  DITHER_LIPSHITZ,
+  DITHER_FWEIGHTED,
+  DITHER_NUMSHAPES
+};
+
 namespace BobDSPLadspa
 {
+  //adds triangular noise of 2 LSB peak to peak, made with 4 xorshift generators in sse lanes,
+  //with noise shaping the signal is quantized to the bit depth, and the quantization error
+  //is filtered and subtracted from the next samples, which moves the noise to frequencies
+  //where it's heard less
   class CDither : public IFilter
   {
     public:
@@ -36,8 +62,16 @@ namespace BobDSPLadspa
       void Deactivate();
 
     private:
-      LADSPA_Data* m_ports[3];
-      unsigned int m_rand;
+      void MakeNoise(float* noise, int samples);
+      void RunShaped(const float* in, float* out, const float* noise, int samples, double precision);
+
+      LADSPA_Data* m_ports[DITHER_NUMPORTS];
+      uint32_t     m_state[4];
+      int          m_shape;
+
+      //the quantization error of the last samples, stored twice so that the history is contiguous
+      double       m_error[DITHER_MAXTAPS * 2];
+      int          m_errorpos;
   };
 }
 #endif //DITHER_H
@@ -28,12 +28,18 @@ using namespace BobDSPLadspa;
 #define SH_COEF (0.816496581f)  // sqrt(2/3)
 #define SL_COEF (0.577350269f)  // sqrt(1/3)
 
-#define LIMITERTIME (0.05f)
+//the outputs might clip, so they go through a limiter, by default without look-ahead so it doesn't add latency,
+//the look-ahead can be turned on when latency doesn't matter, it's not used in low latency mode
+#define LIMITERLOOKAHEAD (0.001f)
+#define LIMITERRELEASE   (0.05f)
 
-CDPL2Encoder::CDPL2Encoder(unsigned long samplerate)
+CDPL2Encoder::CDPL2Encoder(unsigned long samplerate) : m_limiter(samplerate, OUTCHANNELS)
 {
   memset(m_ports, 0, sizeof(m_ports));
-  m_limsamples = lroundf((float)samplerate * LIMITERTIME);
+  m_lowlatency  = false;
+  m_pulsecompat = false;
+  m_lookahead   = false;
+  m_limiter.SetParameters(0.0f, LIMITERRELEASE, 1.0f, false);
   Reset();
 }
 
@@ -47,11 +53,13 @@ void CDPL2Encoder::Reset()
     m_hilberttransform[i].Reset();
 
   memset(m_delaybuf, 0, sizeof(m_delaybuf));
-  m_delaybufpos = 0;
+  m_delaybufpos  = 0;
+  m_delaysamples = m_hilberttransform[0].Latency();
 
-  m_limpos     = 0;
-  m_limgain    = 1.0f;
-  m_limgainmul = 0.0f;
+  for (int i = 0; i < 2; i++)
+    m_hilbertiir[i].Reset();
+
+  m_limiter.Reset();
 }
 
 void CDPL2Encoder::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
@@ -67,103 +75,198 @@ void CDPL2Encoder::Activate()
 
 void OPTIMIZE CDPL2Encoder::Run(unsigned long samplecount)
 {
-  float fl; //front-left
-  float fr; //front-right
-  float ce; //center
-  float rl; //rear-left
-  float rr; //rear-right
-  float lt; //left-total
-  float rt; //right-total
+  //the limiter skips the outputs that are not used, clear it when that changes
+  bool pulsecompat = !!lroundf(*m_ports[PULSECTL]);
+  if (pulsecompat != m_pulsecompat)
+  {
+    m_pulsecompat = pulsecompat;
+    m_limiter.Reset();
+  }
 
-  float limval;
+  //when the filter length of the hilbert transformers changes, their latency changes too
+  //so the delay of the front channels has to change with it
+  for (int i = 0; i < 2; i++)
+    m_hilberttransform[i].SetLength(lroundf(*m_ports[FILTERLEN]));
 
-  bool pulsecompat = !!lroundf(*m_ports[PULSECTL]);
+  if (m_hilberttransform[0].Latency() != m_delaysamples)
+  {
+    memset(m_delaybuf, 0, sizeof(m_delaybuf));
+    m_delaybufpos  = 0;
+    m_delaysamples = m_hilberttransform[0].Latency();
+  }
 
-  for (unsigned long i = 0; i < samplecount; i++)
+  //when switching between the FIR and IIR filters, clear the old state of the one that's used next
+  bool lowlatency = !!lroundf(*m_ports[LOWLATENCY]);
+  if (lowlatency != m_lowlatency)
   {
-    //read input samples from the delay buffers for the front channels,
-    //read input samples from the hilbert transformers for the surround channels
-    fl = m_delaybuf[0][m_delaybufpos];
-    fr = m_delaybuf[1][m_delaybufpos];
-    ce = m_delaybuf[2][m_delaybufpos];
-    rl = m_hilberttransform[0].Process(m_ports[RL_IN][i]);
-    rr = m_hilberttransform[1].Process(m_ports[RR_IN][i]);
-
-    //store the input samples for the front channels into the delay buffers
-    m_delaybuf[0][m_delaybufpos] = m_ports[FL_IN][i];
-    m_delaybuf[1][m_delaybufpos] = m_ports[FR_IN][i];
-    m_delaybuf[2][m_delaybufpos] = m_ports[CE_IN][i];
-
-    //generate the output channels by adding the input channels with their respective coefficients
-    lt = fl + ce * CE_COEF + rl * -SH_COEF + rr * -SL_COEF;
-    rt = fr + ce * CE_COEF + rr *  SH_COEF + rl *  SL_COEF;
+    m_lowlatency = lowlatency;
+    if (lowlatency)
+    {
+      for (int i = 0; i < 2; i++)
+        m_hilbertiir[i].Reset();
+    }
+    else
+    {
+      for (int i = 0; i < 2; i++)
+        m_hilberttransform[i].Reset();
 
-    if (pulsecompat)
+      memset(m_delaybuf, 0, sizeof(m_delaybuf));
+      m_delaybufpos = 0;
+    }
+  }
+
+  bool lookahead = !!lroundf(*m_ports[LOOKAHEAD]) && !lowlatency;
+  if (lookahead != m_lookahead)
+  {
+    m_lookahead = lookahead;
+    m_limiter.SetParameters(lookahead ? LIMITERLOOKAHEAD : 0.0f, LIMITERRELEASE, 1.0f, false);
+  }
+
+  //run the hilbert transformers on blocks of the input channels, before writing any output
+  //in case an output port uses the same buffer as an input port
+  float front[DELAYCHANNELS][MAXBLOCK];
+  float surround[2][MAXBLOCK];
+  for (unsigned long start = 0; start < samplecount; start += MAXBLOCK)
+  {
+    unsigned long end = std::min(samplecount, start + MAXBLOCK);
+
+    if (lowlatency)
     {
-      //when connecting this ladspa plugin in pulseaudio to a stereo sink, by default it mixes the
-      //center channel and the surround channels to left and right, and decreases the volume to prevent clipping
-      //by applying this mix that effect will be undone, so that the full volume is available
-      fl = lt * 1.25f - rt * 0.25f;
-      fr = rt * 1.25f - lt * 0.25f;
-      ce = (lt + rt) * 0.5f;
-      rl = lt;
-      rr = rt;
-
-      //because the output might clip, pass the samples through a limiter with 50 ms hold and release times
-      limval = std::max(fabsf(fl * m_limgain), fabsf(fr * m_limgain));
-      limval = std::max(limval, fabsf(ce * m_limgain));
-      limval = std::max(limval, fabsf(rl * m_limgain));
-      limval = std::max(limval, fabsf(rr * m_limgain));
-      if (limval >= 1.0f)
+      //the front channels go through the reference allpass cascades, the surround
+      //channels through the quadrature cascades, which lag 90 degrees behind
+      const float* in[2][IIRLANES] =
+      {
+        { m_ports[FL_IN] + start, m_ports[RL_IN] + start, m_ports[FR_IN] + start, m_ports[RR_IN] + start },
+        { m_ports[CE_IN] + start, NULL, NULL, NULL }
+      };
+      float* out[2][IIRLANES] =
       {
-        m_limgain    = m_limgain / limval;
-        m_limpos     = m_limsamples * 2;
-        m_limgainmul = powf(1.0f / m_limgain, 1.0f / (float)m_limsamples);
-      }
-
-      //write all output ports
-      m_ports[LT_OUT][i]    = fl * m_limgain;
-      m_ports[RT_OUT][i]    = fr * m_limgain;
-      m_ports[LTRT2_OUT][i] = ce * m_limgain;
-      m_ports[LTS_OUT][i]   = rl * m_limgain;
-      m_ports[RTS_OUT][i]   = rr * m_limgain;
+        { front[0], surround[0], front[1], surround[1] },
+        { front[2], NULL, NULL, NULL }
+      };
+
+      for (int i = 0; i < 2; i++)
+        m_hilbertiir[i].Process(in[i], out[i], end - start);
     }
     else
     {
-      //because the output might clip, pass the samples through a limiter with 50 ms hold and release times
-      limval = std::max(fabsf(lt * m_limgain), fabsf(rt * m_limgain));
-      if (limval >= 1.0f)
-      {
-        m_limgain    = m_limgain / limval;
-        m_limpos     = m_limsamples * 2;
-        m_limgainmul = powf(1.0f / m_limgain, 1.0f / (float)m_limsamples);
-      }
-
-      //write LT and RT, set the other ports to zero
-      m_ports[LT_OUT][i]    = lt * m_limgain;
-      m_ports[RT_OUT][i]    = rt * m_limgain;
-      m_ports[LTRT2_OUT][i] = 0.0f;
-      m_ports[LTS_OUT][i]   = 0.0f;
-      m_ports[RTS_OUT][i]   = 0.0f;
+      //the surround channels go through the hilbert transformers in one pass,
+      //the front channels are delayed by the same amount
+      const float* in[2]  = { m_ports[RL_IN] + start, m_ports[RR_IN] + start };
+      float*       out[2] = { surround[0], surround[1] };
+      CHilbertTransform::ProcessPair(m_hilberttransform, in, out, end - start);
+      DelayFront(front, start, end - start);
+    }
+
+    Mix(front, surround, start, end - start, pulsecompat);
+
+    //limit the outputs in place, in stereo mode only LT and RT are used
+    float* out[OUTCHANNELS];
+    for (int c = 0; c < OUTCHANNELS; c++)
+      out[c] = (c < 2 || pulsecompat) ? m_ports[LT_OUT + c] + start : NULL;
+
+    m_limiter.Process(out, out, end - start);
+  }
+}
+
+//the delay line is as long as the delay, so every sample is read back right before it's overwritten,
+//which is done with a memcpy for every part of the block between the ends of the delay line
+void CDPL2Encoder::DelayFront(float (*front)[MAXBLOCK], unsigned long start, int samples)
+{
+  static const int inports[DELAYCHANNELS] = { FL_IN, FR_IN, CE_IN };
+
+  int done = 0;
+  while (done < samples)
+  {
+    int part = std::min(samples - done, m_delaysamples - m_delaybufpos);
+    for (int c = 0; c < DELAYCHANNELS; c++)
+    {
+      memcpy(front[c] + done, m_delaybuf[c] + m_delaybufpos, part * sizeof(float));
+      memcpy(m_delaybuf[c] + m_delaybufpos, m_ports[inports[c]] + start + done, part * sizeof(float));
     }
 
-    m_delaybufpos++;
-    if (m_delaybufpos >= DELAYSAMPLES)
+    done          += part;
+    m_delaybufpos += part;
+    if (m_delaybufpos >= m_delaysamples)
       m_delaybufpos = 0;
+  }
+}
 
-    //decrease the limiter
-    if (m_limpos > m_limsamples)
+//generates the output channels by adding the input channels with their respective coefficients,
+//when pulseaudio compatibility is off, only LT and RT are used, and the other ports are set to zero
+void OPTIMIZE CDPL2Encoder::Mix(float (*front)[MAXBLOCK], float (*surround)[MAXBLOCK], unsigned long start, int samples, bool pulsecompat)
+{
+  float* out[OUTCHANNELS];
+  for (int c = 0; c < OUTCHANNELS; c++)
+    out[c] = m_ports[LT_OUT + c] + start;
+
+  int i = 0;
+
+#ifdef USE_SSE
+  __m128 cecoef = _mm_set1_ps(CE_COEF);
+  __m128 shcoef = _mm_set1_ps(SH_COEF);
+  __m128 slcoef = _mm_set1_ps(SL_COEF);
+  __m128 onequarter = _mm_set1_ps(0.25f);
+  __m128 fivequarters = _mm_set1_ps(1.25f);
+  __m128 half = _mm_set1_ps(0.5f);
+
+  for (; i + 4 <= samples; i += 4)
+  {
+    __m128 ce = _mm_mul_ps(_mm_loadu_ps(front[2] + i), cecoef);
+    __m128 rl = _mm_loadu_ps(surround[0] + i);
+    __m128 rr = _mm_loadu_ps(surround[1] + i);
+    __m128 lt = _mm_add_ps(_mm_loadu_ps(front[0] + i), ce);
+    __m128 rt = _mm_add_ps(_mm_loadu_ps(front[1] + i), ce);
+    lt = _mm_sub_ps(_mm_sub_ps(lt, _mm_mul_ps(rl, shcoef)), _mm_mul_ps(rr, slcoef));
+    rt = _mm_add_ps(_mm_add_ps(rt, _mm_mul_ps(rr, shcoef)), _mm_mul_ps(rl, slcoef));
+
+    if (pulsecompat)
     {
-      m_limpos--;
+      _mm_storeu_ps(out[0] + i, _mm_sub_ps(_mm_mul_ps(lt, fivequarters), _mm_mul_ps(rt, onequarter)));
+      _mm_storeu_ps(out[1] + i, _mm_sub_ps(_mm_mul_ps(rt, fivequarters), _mm_mul_ps(lt, onequarter)));
+      _mm_storeu_ps(out[2] + i, _mm_mul_ps(_mm_add_ps(lt, rt), half));
+      _mm_storeu_ps(out[3] + i, lt);
+      _mm_storeu_ps(out[4] + i, rt);
     }
-    else if (m_limpos > 0)
+    else
     {
-      m_limgain *= m_limgainmul;
-      m_limpos--;
-      if (m_limpos == 0)
-        m_limgain = 1.0f;
+      _mm_storeu_ps(out[0] + i, lt);
+      _mm_storeu_ps(out[1] + i, rt);
     }
   }
+#endif
+
+  for (; i < samples; i++)
+  {
+    float ce = front[2][i] * CE_COEF;
+    float rl = surround[0][i];
+    float rr = surround[1][i];
+    float lt = front[0][i] + ce - rl * SH_COEF - rr * SL_COEF;
+    float rt = front[1][i] + ce + rr * SH_COEF + rl * SL_COEF;
+
+    if (pulsecompat)
+    {
+      //when connecting this ladspa plugin in pulseaudio to a stereo sink, by default it mixes the
+      //center channel and the surround channels to left and right, and decreases the volume to prevent clipping
+      //by applying this mix that effect will be undone, so that the full volume is available
+      out[0][i] = lt * 1.25f - rt * 0.25f;
+      out[1][i] = rt * 1.25f - lt * 0.25f;
+      out[2][i] = (lt + rt) * 0.5f;
+      out[3][i] = lt;
+      out[4][i] = rt;
+    }
+    else
+    {
+      out[0][i] = lt;
+      out[1][i] = rt;
+    }
+  }
+
+  if (!pulsecompat)
+  {
+    for (int c = 2; c < OUTCHANNELS; c++)
+      memset(out[c], 0, samples * sizeof(float));
+  }
 }
 
 void CDPL2Encoder::Deactivate()
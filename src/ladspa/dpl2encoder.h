@@ -23,10 +23,12 @@
 #include "filterinterface.h"
 
 #include "hilberttransform.h"
+#include "hilberttransformiir.h"
+#include "limiter.h"
 
 #include <math.h>
 
-#define NUMPORTS 11
+#define NUMPORTS 14
 
 //this channel map is compatible with the default pulseaudio channel map
 #define FL_IN     0
@@ -40,10 +42,16 @@
 #define LTS_OUT   8
 #define RTS_OUT   9
 #define PULSECTL 10
+#define FILTERLEN 11
+#define LOWLATENCY 12
+#define LOOKAHEAD 13
 
-#define DELAYSAMPLES  (FILTERSIZE / 2)
+//the front channels are delayed by the same amount as the hilbert transform
+#define DELAYSAMPLES  (HILBERTFFT_MAXLENGTH / 2 + HILBERTFFT_PARTITION)
 #define DELAYCHANNELS (3)
 
+#define OUTCHANNELS 5
+
 namespace BobDSPLadspa
 {
   class CDPL2Encoder : public IFilter
@@ -59,17 +67,21 @@ namespace BobDSPLadspa
 
     private:
       void Reset();
+      void DelayFront(float (*front)[MAXBLOCK], unsigned long start, int samples);
+      void Mix(float (*front)[MAXBLOCK], float (*surround)[MAXBLOCK], unsigned long start, int samples, bool pulsecompat);
 
-      LADSPA_Data*      m_ports[NUMPORTS];
+      LADSPA_Data*         m_ports[NUMPORTS];
 
-      float             m_delaybuf[DELAYCHANNELS][DELAYSAMPLES];
-      int               m_delaybufpos;
-      CHilbertTransform m_hilberttransform[2];
+      float                m_delaybuf[DELAYCHANNELS][DELAYSAMPLES];
+      int                  m_delaybufpos;
+      int                  m_delaysamples;
+      CHilbertTransform    m_hilberttransform[2];
+      CHilbertTransformIIR m_hilbertiir[2];
+      bool                 m_lowlatency;
+      bool                 m_lookahead;
+      bool                 m_pulsecompat;
 
-      int               m_limsamples;
-      float             m_limgain;
-      int               m_limpos;
-      float             m_limgainmul;
+      CLimiter             m_limiter;
   };
 }
 
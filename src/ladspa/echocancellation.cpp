@@ -16,27 +16,61 @@
  * with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <errno.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include "echocancellation.h"
 #include "util/misc.h"
 #include "util/ssedefs.h"
-#include "util/inclstdint.h"
 
 using namespace BobDSPLadspa;
 
 CEchoCancellation::CEchoCancellation(unsigned long samplerate)
 {
   memset(m_ports, 0, sizeof(m_ports));
-  m_echostate = NULL;
   m_samplerate = samplerate;
-  m_filterlength = -1.0f;
-  m_framesize = 0;
+
+  m_framesize = 1;
+  while (m_framesize < EC_FRAMETIME * m_samplerate)
+    m_framesize *= 2;
+
+  m_inframe   = (int16_t*)aligned_alloc(ALIGN, m_framesize * sizeof(int16_t));
+  m_echoframe = (int16_t*)aligned_alloc(ALIGN, m_framesize * sizeof(int16_t));
+  m_outframe  = (int16_t*)aligned_alloc(ALIGN, m_framesize * sizeof(int16_t));
+
+  //until a speex state is made, the input is passed through
+  m_echostate = NULL;
+  m_newstate  = NULL;
+  m_oldstate  = NULL;
+  m_length    = -1;
+  m_made      = -1;
+  m_finished  = -1;
+  m_stop      = false;
+
+  Activate();
+
+  sem_init(&m_statesem, 0, 0);
+  pthread_create(&m_thread, NULL, StateThread, this);
 }
 
 CEchoCancellation::~CEchoCancellation()
 {
+  m_stop = true;
+  sem_post(&m_statesem);
+  pthread_join(m_thread, NULL);
+  sem_destroy(&m_statesem);
+
   if (m_echostate)
     speex_echo_state_destroy(m_echostate);
+  if (m_newstate)
+    speex_echo_state_destroy(m_newstate);
+  if (m_oldstate)
+    speex_echo_state_destroy(m_oldstate);
+
+  free(m_inframe);
+  free(m_echoframe);
+  free(m_outframe);
 }
 
 void CEchoCancellation::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
@@ -46,55 +80,154 @@ void CEchoCancellation::ConnectPort(unsigned long port, LADSPA_Data* datalocatio
 
 void CEchoCancellation::Activate()
 {
+  memset(m_inframe, 0, m_framesize * sizeof(int16_t));
+  memset(m_echoframe, 0, m_framesize * sizeof(int16_t));
+  memset(m_outframe, 0, m_framesize * sizeof(int16_t));
+  m_fill = 0;
 }
 
-#define INLINE inline __attribute__((always_inline))
+//converts to 16 bits with rounding and saturation, 8 samples at a time
+static void OPTIMIZE FloatToInt16(const float* in, int16_t* out, int samples)
+{
+  int i = 0;
+#if defined(USE_SSE) && defined(__SSE2__)
+  __m128 scale = _mm_set1_ps(32768.0f);
+  for (; i + 7 < samples; i += 8)
+  {
+    __m128i low  = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i), scale));
+    __m128i high = _mm_cvtps_epi32(_mm_mul_ps(_mm_loadu_ps(in + i + 4), scale));
+    _mm_storeu_si128((__m128i*)(out + i), _mm_packs_epi32(low, high));
+  }
+#endif
+  for (; i < samples; i++)
+    out[i] = Clamp(Round32(in[i] * 32768.0f), INT16_MIN, INT16_MAX);
+}
+
+static void OPTIMIZE Int16ToFloat(const int16_t* in, float* out, int samples)
+{
+  int i = 0;
+#if defined(USE_SSE) && defined(__SSE2__)
+  __m128 scale = _mm_set1_ps(1.0f / 32768.0f);
+  for (; i + 7 < samples; i += 8)
+  {
+    //sign extend to 32 bits by putting the samples in the upper halves, and shifting them down
+    __m128i samples16 = _mm_loadu_si128((const __m128i*)(in + i));
+    __m128i low  = _mm_srai_epi32(_mm_unpacklo_epi16(samples16, samples16), 16);
+    __m128i high = _mm_srai_epi32(_mm_unpackhi_epi16(samples16, samples16), 16);
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_cvtepi32_ps(low), scale));
+    _mm_storeu_ps(out + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(high), scale));
+  }
+#endif
+  for (; i < samples; i++)
+    out[i] = (float)in[i] / 32768.0f;
+}
 
-void INLINE OPTIMIZE FloatToInt16(float* in, int16_t* out, unsigned long samplecount)
+void CEchoCancellation::Run(unsigned long samplecount)
 {
-  float*   inptr  = in;
-  float*   inend  = in + samplecount;
-  int16_t* outptr = out;
+  Update();
 
-  while (inptr != inend)
-    *(outptr++) = Clamp(Round32(*(inptr++) * 32768.0f), INT16_MIN, INT16_MAX);
+  //the output of the previous frame is read out while the current frame is filled
+  unsigned long i = 0;
+  while (i < samplecount)
+  {
+    int samples = Min((int)(samplecount - i), m_framesize - m_fill);
+
+    FloatToInt16(m_ports[EC_IN] + i, m_inframe + m_fill, samples);
+    FloatToInt16(m_ports[EC_ECHO] + i, m_echoframe + m_fill, samples);
+    Int16ToFloat(m_outframe + m_fill, m_ports[EC_OUT] + i, samples);
+
+    i      += samples;
+    m_fill += samples;
+    if (m_fill == m_framesize)
+    {
+      ProcessFrame();
+      m_fill = 0;
+    }
+  }
 }
 
-void INLINE OPTIMIZE Int16ToFloat(int16_t* in, float* out, unsigned long samplecount)
+void CEchoCancellation::ProcessFrame()
 {
-  int16_t* inptr  = in;
-  int16_t* inend  = in + samplecount;
-  float*   outptr = out;
+  if (m_echostate)
+    speex_echo_cancellation(m_echostate, m_inframe, m_echoframe, m_outframe);
+  else
+    memcpy(m_outframe, m_inframe, m_framesize * sizeof(int16_t));
+}
 
-  while (inptr != inend)
-    *(outptr++) = (float)*(inptr++) / 32768.0f;
+void CEchoCancellation::Deactivate()
+{
 }
 
-void CEchoCancellation::Run(unsigned long samplecount)
+//waits until the speex state for the current filter length is made, and taken by Update()
+void CEchoCancellation::WaitLoaded()
 {
-  if (m_echostate == NULL || *(m_ports[3]) != m_filterlength || samplecount != m_framesize)
+  for(;;)
   {
-    m_filterlength = *(m_ports[3]);
-    m_framesize = samplecount;
-    if (m_echostate)
-      speex_echo_state_destroy(m_echostate);
+    Update();
+    if (__atomic_load_n(&m_finished, __ATOMIC_ACQUIRE) == m_length &&
+        __atomic_load_n(&m_newstate, __ATOMIC_ACQUIRE) == NULL)
+      break;
 
-    m_echostate = speex_echo_state_init(m_framesize, Max(Round32(m_filterlength * (float)m_samplerate), 1));
+    usleep(1000);
   }
+}
 
-  int16_t inbuf[samplecount];
-  int16_t echobuf[samplecount];
-  int16_t outbuf[samplecount];
+void CEchoCancellation::Update()
+{
+  bool wakethread = false;
 
-  FloatToInt16(m_ports[0], inbuf, samplecount);
-  FloatToInt16(m_ports[1], echobuf, samplecount);
+  int length = Max(Round32(*m_ports[EC_FILTERLEN] * (float)m_samplerate), 1);
+  if (length != m_length)
+  {
+    __atomic_store_n(&m_length, length, __ATOMIC_RELEASE);
+    wakethread = true;
+  }
 
-  speex_echo_cancellation(m_echostate, inbuf, echobuf, outbuf);
+  //take the new state from the state thread, the old state is handed back to it to destroy it,
+  //wait until the state thread has destroyed the previous old state
+  if (__atomic_load_n(&m_oldstate, __ATOMIC_ACQUIRE) == NULL)
+  {
+    SpeexEchoState* state = __atomic_exchange_n(&m_newstate, NULL, __ATOMIC_ACQ_REL);
+    if (state)
+    {
+      __atomic_store_n(&m_oldstate, m_echostate, __ATOMIC_RELEASE);
+      m_echostate = state;
+      wakethread  = true;
+    }
+  }
 
-  Int16ToFloat(outbuf, m_ports[2], samplecount);
+  if (wakethread)
+    sem_post(&m_statesem);
 }
 
-void CEchoCancellation::Deactivate()
+void* CEchoCancellation::StateThread(void* arg)
 {
-}
+  CEchoCancellation* ec = (CEchoCancellation*)arg;
+  for(;;)
+  {
+    while (sem_wait(&ec->m_statesem) != 0 && errno == EINTR);
+
+    if (ec->m_stop)
+      break;
+
+    SpeexEchoState* oldstate = __atomic_exchange_n(&ec->m_oldstate, NULL, __ATOMIC_ACQ_REL);
+    if (oldstate)
+      speex_echo_state_destroy(oldstate);
 
+    int length = __atomic_load_n(&ec->m_length, __ATOMIC_ACQUIRE);
+    if (length > 0 && length != ec->m_made)
+    {
+      ec->m_made = length;
+
+      //if the realtime thread didn't take the previous new state yet, it's replaced
+      SpeexEchoState* state = speex_echo_state_init(ec->m_framesize, length);
+      SpeexEchoState* prev  = __atomic_exchange_n(&ec->m_newstate, state, __ATOMIC_ACQ_REL);
+      if (prev)
+        speex_echo_state_destroy(prev);
+
+      __atomic_store_n(&ec->m_finished, length, __ATOMIC_RELEASE);
+    }
+  }
+
+  return NULL;
+}
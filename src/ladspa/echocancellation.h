@@ -19,12 +19,29 @@
 #ifndef ECHOCANCELLATION_H
 #define ECHOCANCELLATION_H
 
-#include <speex/speex_echo.h> 
+#include <pthread.h>
+#include <semaphore.h>
+#include <speex/speex_echo.h>
+#include "util/inclstdint.h"
 #include "filterdescriptions.h"
 #include "filterinterface.h"
 
+#define EC_IN          0
+#define EC_ECHO        1
+#define EC_OUT         2
+#define EC_FILTERLEN   3
+#define EC_NUMPORTS    4
+
+//speex runs on frames of a fixed size, the power of two at or above this time
+#define EC_FRAMETIME   0.01
+
 namespace BobDSPLadspa
 {
+  //the samples go through a fifo of one frame, so the speex frame size doesn't depend on
+  //how many samples the host passes to Run(), this adds a delay of one frame
+  //
+  //when the filter length changes, a new speex state is made in a separate thread,
+  //and handed to the realtime thread, like CConvolver does with its engines
   class CEchoCancellation : public IFilter
   {
     public:
@@ -35,13 +52,32 @@ namespace BobDSPLadspa
       void Activate();
       void Run(unsigned long samplecount);
       void Deactivate();
+      void WaitLoaded();
 
     private:
-      LADSPA_Data*    m_ports[4];
-      SpeexEchoState* m_echostate;
+      void            Update();
+      void            ProcessFrame();
+      static void*    StateThread(void* arg);
+
+      LADSPA_Data*    m_ports[EC_NUMPORTS];
       unsigned long   m_samplerate;
-      float           m_filterlength;
-      unsigned long   m_framesize;
+      int             m_framesize;
+      int             m_fill;     //samples in the current frame
+
+      int16_t*        m_inframe;
+      int16_t*        m_echoframe;
+      int16_t*        m_outframe; //output of the previous frame, read while the current frame fills
+
+      SpeexEchoState* m_echostate;  //only used by the realtime thread
+      SpeexEchoState* m_newstate;   //handed from the state thread to the realtime thread
+      SpeexEchoState* m_oldstate;   //handed from the realtime thread to the state thread to destroy it
+      int             m_length;     //filter length in samples, requested by the realtime thread
+      int             m_made;       //filter length of the last state made by the state thread
+      int             m_finished;   //m_made after its state is handed to the realtime thread
+
+      pthread_t       m_thread;
+      sem_t           m_statesem;
+      volatile bool   m_stop;
   };
 }
 
@@ -0,0 +1,59 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EXTENSIONS_H
+#define EXTENSIONS_H
+
+//bobdsp.so exports these functions next to ladspa_descriptor()
+//they let bobdsp ask its own plugins for things the ladspa api doesn't cover,
+//since other ladspa libraries don't have them, they are looked up with dlsym()
+
+#include <ladspa.h>
+
+//returns non-zero when the audio outputs of the instance are equal to its audio inputs
+//with the current control values, the first input to the first output and so on,
+//the host can then skip running the instance and copy the audio instead
+#define BOBDSP_IS_IDENTITY "bobdsp_is_identity"
+typedef int (*BobDSP_Is_Identity_Function)(LADSPA_Handle Instance);
+
+//called by the host instead of run() when it skipped running the instance for a period,
+//the instance can then tell that its state doesn't follow the audio anymore
+#define BOBDSP_SKIPPED "bobdsp_skipped"
+typedef void (*BobDSP_Skipped_Function)(LADSPA_Handle Instance);
+
+//called by the host after instantiate() with the realtime priority of the thread that calls run(),
+//or -1 when it doesn't run in realtime, plugins with worker threads that run() depends on
+//run them at a lower priority than that, so that they can't be preempted by unrelated realtime threads,
+//it's called again from the thread that calls run(), between calls to run(), when that thread
+//stops or starts running in realtime, run() may only wait on worker threads when it's not realtime
+#define BOBDSP_SET_RT_PRIORITY "bobdsp_set_rt_priority"
+typedef void (*BobDSP_Set_RT_Priority_Function)(LADSPA_Handle Instance, int Priority);
+
+//called by the host before the instance runs in realtime, after it has run it for a while,
+//blocks until the work the instance handed to its own threads for the current control values
+//is done, like loading an impulse response, so that the next run() can use the result
+#define BOBDSP_WAIT_LOADED "bobdsp_wait_loaded"
+typedef void (*BobDSP_Wait_Loaded_Function)(LADSPA_Handle Instance);
+
+//returns non-zero when the plugin smooths changes of its control inputs itself,
+//the host then passes new control values directly, instead of moving them towards
+//the new value in small steps, which needs running the plugin on small blocks
+#define BOBDSP_SMOOTHS_CONTROLS "bobdsp_smooths_controls"
+typedef int (*BobDSP_Smooths_Controls_Function)(const LADSPA_Descriptor* Descriptor);
+
+#endif //EXTENSIONS_H
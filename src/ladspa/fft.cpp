@@ -0,0 +1,215 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fft.h"
+#include "util/ssedefs.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace BobDSPLadspa;
+
+static float* AllocFloats(int size)
+{
+  float* buf = (float*)aligned_alloc(ALIGN, ((size * sizeof(float) + ALIGN - 1) / ALIGN) * ALIGN);
+  memset(buf, 0, size * sizeof(float));
+  return buf;
+}
+
+CFFT::CFFT(int maxsize)
+{
+  m_maxsize = maxsize;
+  m_size    = 0;
+  m_sinre   = AllocFloats(maxsize / 2);
+  m_sinim   = AllocFloats(maxsize / 2);
+  m_stagere = AllocFloats(maxsize / 2);
+  m_stageim = AllocFloats(maxsize / 2);
+  m_workre  = AllocFloats(maxsize / 2);
+  m_workim  = AllocFloats(maxsize / 2);
+
+  for (int k = 0; k < maxsize / 2; k++)
+  {
+    double phase = -2.0 * M_PI * k / maxsize;
+    m_sinre[k] = cos(phase);
+    m_sinim[k] = sin(phase);
+  }
+
+  //the real fft runs a complex fft of half the size, store the twiddles of every stage
+  //after each other, so that the butterflies read them sequentially,
+  //the stages of a smaller fft are the first stages of a larger one, so this works for every size
+  int    complexsize = maxsize / 2;
+  float* stagere     = m_stagere;
+  float* stageim     = m_stageim;
+  for (int len = 2; len <= complexsize; len *= 2)
+  {
+    int stride = maxsize / len;
+    for (int k = 0; k < len / 2; k++)
+    {
+      stagere[k] = m_sinre[k * stride];
+      stageim[k] = m_sinim[k * stride];
+    }
+
+    stagere += len / 2;
+    stageim += len / 2;
+  }
+
+  SetSize(maxsize);
+}
+
+CFFT::~CFFT()
+{
+  free(m_sinre);
+  free(m_sinim);
+  free(m_stagere);
+  free(m_stageim);
+  free(m_workre);
+  free(m_workim);
+}
+
+void CFFT::SetSize(int size)
+{
+  m_size = size;
+}
+
+void OPTIMIZE CFFT::Complex(float* re, float* im)
+{
+  int size = m_size / 2;
+
+  //reorder the input into bit reversed order
+  for (int i = 0, j = 0; i < size; i++)
+  {
+    if (i < j)
+    {
+      float tmp;
+      tmp = re[i]; re[i] = re[j]; re[j] = tmp;
+      tmp = im[i]; im[i] = im[j]; im[j] = tmp;
+    }
+
+    int bit = size >> 1;
+    while (j & bit)
+    {
+      j ^= bit;
+      bit >>= 1;
+    }
+    j |= bit;
+  }
+
+  //decimation in time butterflies
+  const float* stagere = m_stagere;
+  const float* stageim = m_stageim;
+  for (int len = 2; len <= size; len *= 2)
+  {
+    int half = len / 2;
+    for (int i = 0; i < size; i += len)
+    {
+      float* are = re + i;
+      float* aim = im + i;
+      float* bre = are + half;
+      float* bim = aim + half;
+      for (int k = 0; k < half; k++)
+      {
+        float tre = bre[k] * stagere[k] - bim[k] * stageim[k];
+        float tim = bre[k] * stageim[k] + bim[k] * stagere[k];
+        bre[k] = are[k] - tre;
+        bim[k] = aim[k] - tim;
+        are[k] += tre;
+        aim[k] += tim;
+      }
+    }
+
+    stagere += half;
+    stageim += half;
+  }
+}
+
+void OPTIMIZE CFFT::RealForward(const float* in, float* re, float* im)
+{
+  int half   = m_size / 2;
+  int stride = m_maxsize / m_size;
+
+  //pack the even samples into the real part, and the odd samples into the imaginary part
+  for (int k = 0; k < half; k++)
+  {
+    m_workre[k] = in[k * 2];
+    m_workim[k] = in[k * 2 + 1];
+  }
+
+  Complex(m_workre, m_workim);
+
+  //split the spectrum into the spectra of the even and odd samples, and combine them
+  re[0]    = m_workre[0] + m_workim[0];
+  im[0]    = 0.0f;
+  re[half] = m_workre[0] - m_workim[0];
+  im[half] = 0.0f;
+  for (int k = 1; k < half; k++)
+  {
+    float zre  = m_workre[k];
+    float zim  = m_workim[k];
+    float zcre = m_workre[half - k];
+    float zcim = -m_workim[half - k];
+
+    float evenre = (zre + zcre) * 0.5f;
+    float evenim = (zim + zcim) * 0.5f;
+    float oddre  = (zim - zcim) * 0.5f;
+    float oddim  = (zcre - zre) * 0.5f;
+
+    float wre = m_sinre[k * stride];
+    float wim = m_sinim[k * stride];
+
+    re[k] = evenre + oddre * wre - oddim * wim;
+    im[k] = evenim + oddre * wim + oddim * wre;
+  }
+}
+
+void OPTIMIZE CFFT::RealInverse(const float* re, const float* im, float* out)
+{
+  int half   = m_size / 2;
+  int stride = m_maxsize / m_size;
+
+  //undo the combining of the even and odd spectra, the inverse fft is done with a forward fft
+  //on the complex conjugate, so the imaginary parts are negated here
+  for (int k = 0; k < half; k++)
+  {
+    float xre  = re[k];
+    float xim  = im[k];
+    float xcre = re[half - k];
+    float xcim = -im[half - k];
+
+    float evenre = (xre + xcre) * 0.5f;
+    float evenim = (xim + xcim) * 0.5f;
+    float dre    = (xre - xcre) * 0.5f;
+    float dim    = (xim - xcim) * 0.5f;
+
+    //multiply by the complex conjugate of the twiddle
+    float wre   = m_sinre[k * stride];
+    float wim   = -m_sinim[k * stride];
+    float oddre = dre * wre - dim * wim;
+    float oddim = dre * wim + dim * wre;
+
+    m_workre[k] = evenre - oddim;
+    m_workim[k] = -(evenim + oddre);
+  }
+
+  Complex(m_workre, m_workim);
+
+  for (int k = 0; k < half; k++)
+  {
+    out[k * 2]     = m_workre[k];
+    out[k * 2 + 1] = -m_workim[k];
+  }
+}
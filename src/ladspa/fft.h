@@ -0,0 +1,59 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef FFT_H
+#define FFT_H
+
+namespace BobDSPLadspa
+{
+  //radix-2 fft on real signals, with the real and imaginary parts of the spectrum in separate arrays
+  //all memory is allocated in the constructor for the maximum size, so the size can be changed
+  //from the realtime thread
+  class CFFT
+  {
+    public:
+      CFFT(int maxsize);
+      ~CFFT();
+
+      //size has to be a power of two, and no larger than maxsize,
+      //this only stores the size, the twiddles for every size are made in the constructor
+      void SetSize(int size);
+      int  Size() { return m_size; }
+
+      //transforms size real samples into size / 2 + 1 complex bins
+      void RealForward(const float* in, float* re, float* im);
+
+      //transforms size / 2 + 1 complex bins into size real samples,
+      //the output is not normalized, it is multiplied by size / 2
+      void RealInverse(const float* re, const float* im, float* out);
+
+    private:
+      void Complex(float* re, float* im);
+
+      int    m_maxsize;
+      int    m_size;
+      float* m_sinre;   //e^(-2*pi*i*k/maxsize) for k < maxsize / 2
+      float* m_sinim;
+      float* m_stagere; //twiddles for every stage of the complex fft of the maximum size
+      float* m_stageim;
+      float* m_workre;  //the complex fft runs on these
+      float* m_workim;
+  };
+}
+
+#endif //FFT_H
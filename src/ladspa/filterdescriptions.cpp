@@ -20,9 +20,59 @@
 #include "config.h"
 #include "filterdescriptions.h"
 #include "filterinterface.h"
+#include "hilberttransformfft.h"
+#include "parametriceq.h"
+#include "crossover.h"
+#include "limiterplugin.h"
+#include "oversampler.h"
+#include "loudness.h"
+#include "spectrum.h"
+#include "matrixmixer.h"
+#include "dither.h"
+#include "compressor.h"
 
 using namespace BobDSPLadspa;
 
+//ports, names and hints of a band of the parametric equalizer
+#define EQBANDPORTS\
+  LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,\
+  LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,\
+  LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL,\
+  LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL
+
+#define EQBANDNAMES(band)\
+  "Band " #band " type",\
+  "Band " #band " frequency",\
+  "Band " #band " Q",\
+  "Band " #band " gain (dB)"
+
+//type 0 is off, then peaking, low shelf, high shelf, low pass, high pass, notch and allpass, see EEQBAND
+#define EQBANDHINTS\
+  {\
+    LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |\
+    LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_0,\
+    EQ_OFF,\
+    EQ_NUMBANDTYPES - 1\
+  },\
+  {\
+    LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |\
+    LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_MIDDLE,\
+    10.0f,\
+    20000.0f\
+  },\
+  {\
+    LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |\
+    LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_1,\
+    0.1f,\
+    20.0f\
+  },\
+  {\
+    LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |\
+    LADSPA_HINT_DEFAULT_0,\
+    -24.0f,\
+    24.0f\
+  }
+
 #define FUNCTIONPTRS\
   Instantiate,\
   ConnectPort,\
@@ -33,6 +83,20 @@ using namespace BobDSPLadspa;
   Deactivate,\
   Cleanup,
 
+//filter length of the hilbert transform in taps, the shortest length is the
+//FIR filter, longer lengths use fft convolution and have more latency
+#define HILBERTLENGTHNAME "Filter length: up to 512 taps the latency is half the length, " \
+                          "above that half the length plus 512, 8192 taps is 96 ms at 48 kHz"
+
+#define HILBERTLENGTHHINT\
+  {\
+    LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |\
+    LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_INTEGER       |\
+    LADSPA_HINT_DEFAULT_MINIMUM,\
+    HILBERTFFT_MINLENGTH,\
+    HILBERTFFT_MAXLENGTH\
+  }
+
 const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
 {
   {
@@ -100,18 +164,20 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
     "BobDSP Dither",
     "Bob",
     "GPLv3",
-    3,
+    DITHER_NUMPORTS,
     (const int[])
     {
       LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
       LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
     },
     (const char*[])
     {
       "Input",
       "Output",
       "Bit depth",
+      "Noise shaping (0=none, 1=1st order, 2=2nd order, 3=lipshitz, 4=f-weighted)",
     },
     (const LADSPA_PortRangeHint[])
     {
@@ -122,6 +188,12 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
         LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_MIDDLE,
         0.0f,
         32.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0,
+        DITHER_NONE,
+        DITHER_NUMSHAPES - 1
       }
     },
     NULL,
@@ -299,18 +371,20 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
     "BobDSP pwm",
     "Bob",
     "GPLv3",
-    3,
+    4,
     (const int[])
     {
       LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
       LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
     },
     (const char*[])
     {
       "Input",
       "Output",
-      "Samples"
+      "Samples",
+      "Oversampling (2^n)"
     },
     (const LADSPA_PortRangeHint[])
     {
@@ -321,6 +395,12 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
         LADSPA_HINT_DEFAULT_MIDDLE | LADSPA_HINT_INTEGER,
         1.0f,
         512.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_DEFAULT_0 | LADSPA_HINT_INTEGER,
+        0.0f,
+        OS_MAXSTAGES
       }
     },
     NULL,
@@ -333,7 +413,7 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
     "BobDSP Dolby Pro Logic II Encoder",
     "Bob",
     "GPLv3",
-    11,
+    14,
     (const int[])
     {
       LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
@@ -346,6 +426,9 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
       LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL
     },
     (const char*[])
@@ -360,7 +443,10 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
       "LTRT/2",
       "LTS",
       "RTS",
-      "Pulseaudio compatible mix"
+      "Pulseaudio compatible mix",
+      HILBERTLENGTHNAME,
+      "Low latency",
+      "Limiter look-ahead, adds 1 ms latency (47 samples at 48 kHz)"
     },
     (const LADSPA_PortRangeHint[])
     {
@@ -374,6 +460,13 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
       {},
       {},
       {},
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0
+      },
+      HILBERTLENGTHHINT,
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0
+      },
       {
         LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0
       }
@@ -388,7 +481,7 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
     "BobDSP Hilbert tranform",
     "Bob",
     "GPLv3",
-    6,
+    8,
     (const int[])
     {
       LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
@@ -396,6 +489,8 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
       LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
       LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
       LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL
     },
     (const char*[])
@@ -405,7 +500,9 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
       "Left-Out",
       "Right-Out",
       "Dry/Wet Left",
-      "Dry/Wet Right"
+      "Dry/Wet Right",
+      HILBERTLENGTHNAME,
+      "Low latency"
     },
     (const LADSPA_PortRangeHint[])
     {
@@ -414,7 +511,11 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
       {},
       {},
       {LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_1, 0.0f, 1.0f},
-      {LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_1, 0.0f, 1.0f}
+      {LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE | LADSPA_HINT_DEFAULT_1, 0.0f, 1.0f},
+      HILBERTLENGTHHINT,
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0
+      }
     },
     NULL,
     FUNCTIONPTRS
@@ -466,6 +567,598 @@ const LADSPA_Descriptor CFilterDescriptions::m_descriptors[] =
     },
     NULL,
     FUNCTIONPTRS
+  },
+  {
+    CONVOLVER,
+    "convolver",
+    0,
+    "BobDSP convolver",
+    "Bob",
+    "GPLv3",
+    4,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL
+    },
+    (const char*[])
+    {
+      "Input",
+      "Output",
+      "Impulse response",
+      "Late blocks"
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0,
+        0.0f,
+        999.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_INTEGER,
+        0.0f,
+        0.0f
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    PARAMETRICEQ,
+    "parametriceq",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "BobDSP parametric equalizer",
+    "Bob",
+    "GPLv3",
+    EQ_NUMPORTS,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS,
+      EQBANDPORTS
+    },
+    (const char*[])
+    {
+      "Input",
+      "Output",
+      EQBANDNAMES(1),
+      EQBANDNAMES(2),
+      EQBANDNAMES(3),
+      EQBANDNAMES(4),
+      EQBANDNAMES(5),
+      EQBANDNAMES(6),
+      EQBANDNAMES(7),
+      EQBANDNAMES(8),
+      EQBANDNAMES(9),
+      EQBANDNAMES(10)
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS,
+      EQBANDHINTS
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    CROSSOVER,
+    "crossover",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "BobDSP Linkwitz-Riley crossover",
+    "Bob",
+    "GPLv3",
+    XO_NUMPORTS,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL
+    },
+    (const char*[])
+    {
+      "Input",
+      "Band 1",
+      "Band 2",
+      "Band 3",
+      "Band 4",
+      "Bands",
+      "Type (LR2, LR4, LR8)",
+      "Frequency 1",
+      "Frequency 2",
+      "Frequency 3",
+      "Phase compensation"
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      {},
+      {},
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_MINIMUM,
+        2.0f,
+        XO_MAXBANDS
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_1,
+        XO_LR2,
+        XO_NUMTYPES - 1
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_LOW,
+        20.0f,
+        20000.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_MIDDLE,
+        20.0f,
+        20000.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_HIGH,
+        20.0f,
+        20000.0f
+      },
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_1
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    LIMITER,
+    "limiter",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "BobDSP look-ahead limiter",
+    "Bob",
+    "GPLv3",
+    LIM_NUMPORTS,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL
+    },
+    (const char*[])
+    {
+      "Left-In",
+      "Right-In",
+      "Left-Out",
+      "Right-Out",
+      "Look-ahead (ms)",
+      "Release (ms)",
+      "Ceiling (dB)",
+      "True peak",
+      "Link group",
+      "Gain reduction (dB)"
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      {},
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_LOW,
+        0.0f,
+        LIMITER_MAXLOOKAHEAD * 1000.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_MIDDLE,
+        1.0f,
+        2500.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_DEFAULT_0,
+        -24.0f,
+        0.0f
+      },
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_1
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_0,
+        0.0f,
+        LIMITER_MAXGROUPS
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        0.0f,
+        0.0f
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    LOUDNESS,
+    "loudness",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "BobDSP EBU R128 loudness meter",
+    "Bob",
+    "GPLv3",
+    LOUD_NUMPORTS,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL
+    },
+    (const char*[])
+    {
+      "Input 1",
+      "Input 2",
+      "Input 3",
+      "Input 4",
+      "Input 5",
+      "Input 6",
+      "Input 7",
+      "Input 8",
+      "Channels",
+      "Reset",
+      "Momentary (LUFS)",
+      "Short-term (LUFS)",
+      "Integrated (LUFS)",
+      "True peak (dBTP)"
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_MAXIMUM,
+        1.0f,
+        LOUD_MAXCHANNELS
+      },
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        LOUD_FLOOR,
+        0.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        LOUD_FLOOR,
+        0.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        LOUD_FLOOR,
+        0.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        LOUD_FLOOR,
+        0.0f
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    SPECTRUM,
+    "spectrum",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "BobDSP spectrum analyser",
+    "Bob",
+    "GPLv3",
+    SPEC_NUMPORTS,
+    CSpectrum::PortDescriptors(),
+    CSpectrum::PortNames(),
+    CSpectrum::PortRangeHints(),
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    MATRIXMIXER,
+    "matrixmixer",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE | LADSPA_PROPERTY_INPLACE_BROKEN,
+    "BobDSP 16x16 matrix mixer",
+    "Bob",
+    "GPLv3",
+    MIX_NUMPORTS,
+    CMatrixMixer::PortDescriptors(),
+    CMatrixMixer::PortNames(),
+    CMatrixMixer::PortRangeHints(),
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    NOISEMETERDETECTCONTROL,
+    "noisemeterdetectcontrol",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "noisemeter detect, with a control output",
+    "Bob, original weighting code by Fons Adriaensen",
+    "GPLv3",
+    4,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+    },
+    (const char*[])
+    {
+      "Input",
+      "Level",
+      "Detect: 0=ITU468, 1=RMS, 2=average",
+      "Slow"
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        0.0f,
+        0.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_1,
+        0.0f,
+        2.0f
+      },
+      {
+        LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    NOISEMETERWEIGHTING4,
+    "noisemeterweighting4",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "noisemeter weighting, 4 channels",
+    "Bob, original weighting code by Fons Adriaensen",
+    "GPLv3",
+    9,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+    },
+    (const char*[])
+    {
+      "Input 1",
+      "Input 2",
+      "Input 3",
+      "Input 4",
+      "Output 1",
+      "Output 2",
+      "Output 3",
+      "Output 4",
+      "Weighting: 0=flat, 1=20k low pass, 2=A weighing, 3=C weighting, 4=ITU-R468, 5=ITU-R468 Dolby variant",
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER | LADSPA_HINT_DEFAULT_0,
+        0.0f,
+        5.0f
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
+  },
+  {
+    COMPRESSOR,
+    "compressor",
+    LADSPA_PROPERTY_HARD_RT_CAPABLE,
+    "BobDSP compressor/expander/gate",
+    "Bob",
+    "GPLv3",
+    CMP_NUMPORTS,
+    (const int[])
+    {
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_INPUT  | LADSPA_PORT_CONTROL,
+      LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL
+    },
+    (const char*[])
+    {
+      "Input 1",
+      "Input 2",
+      "Input 3",
+      "Input 4",
+      "Output 1",
+      "Output 2",
+      "Output 3",
+      "Output 4",
+      "Mode: 0=compressor, 1=expander, 2=gate",
+      "Detector: 0=peak, 1=RMS",
+      "Threshold (dB)",
+      "Ratio",
+      "Knee (dB)",
+      "Attack (ms)",
+      "Release (ms)",
+      "Range (dB)",
+      "Makeup gain (dB)",
+      "Link: 0=off, 1=pairs, 2=all channels",
+      "Gain reduction (dB)"
+    },
+    (const LADSPA_PortRangeHint[])
+    {
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {},
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_0,
+        0.0f,
+        2.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_0,
+        0.0f,
+        1.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_DEFAULT_HIGH,
+        -60.0f,
+        0.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_LOW,
+        1.0f,
+        20.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_DEFAULT_LOW,
+        0.0f,
+        24.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_LOW,
+        0.1f,
+        1000.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_MIDDLE,
+        1.0f,
+        5000.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_DEFAULT_LOW,
+        -80.0f,
+        0.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_DEFAULT_0,
+        0.0f,
+        30.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+        LADSPA_HINT_INTEGER       | LADSPA_HINT_DEFAULT_1,
+        0.0f,
+        2.0f
+      },
+      {
+        LADSPA_HINT_BOUNDED_BELOW,
+        0.0f,
+        0.0f
+      }
+    },
+    NULL,
+    FUNCTIONPTRS
   }
 };
 
@@ -34,7 +34,17 @@ enum EFILTER
   PWM,
   DPL2ENCODER,
   HILBERTTRANSFORM,
-  DISTANCEDELAY
+  DISTANCEDELAY,
+  CONVOLVER,
+  PARAMETRICEQ,
+  CROSSOVER,
+  LIMITER,
+  LOUDNESS,
+  SPECTRUM,
+  MATRIXMIXER,
+  NOISEMETERDETECTCONTROL,
+  NOISEMETERWEIGHTING4,
+  COMPRESSOR
 };
 
 namespace BobDSPLadspa
@@ -28,8 +28,17 @@
 #include "dpl2encoder.h"
 #include "hilberttransformplugin.h"
 #include "distancedelay.h"
+#include "convolver.h"
+#include "parametriceq.h"
+#include "crossover.h"
+#include "limiterplugin.h"
+#include "loudness.h"
+#include "spectrum.h"
+#include "matrixmixer.h"
+#include "compressor.h"
 #include "filterdescriptions.h"
 #include "filterinterface.h"
+#include "extensions.h"
 
 #ifdef USE_SPEEX
   #include "echocancellation.h"
@@ -44,6 +53,33 @@ extern "C"
     const LADSPA_Descriptor* descriptor = CFilterDescriptions::Descriptor(Index);
     return descriptor;
   }
+
+  int bobdsp_is_identity(LADSPA_Handle instance)
+  {
+    return ((IFilter*)instance)->IsIdentity() ? 1 : 0;
+  }
+
+  void bobdsp_skipped(LADSPA_Handle instance)
+  {
+    ((IFilter*)instance)->Skipped();
+  }
+
+  void bobdsp_wait_loaded(LADSPA_Handle instance)
+  {
+    ((IFilter*)instance)->WaitLoaded();
+  }
+
+  void bobdsp_set_rt_priority(LADSPA_Handle instance, int priority)
+  {
+    ((IFilter*)instance)->SetRealtimePriority(priority);
+  }
+
+  int bobdsp_smooths_controls(const LADSPA_Descriptor* descriptor)
+  {
+    //CBiquad interpolates its coefficients when the controls change,
+    //CMatrixMixer ramps its gains
+    return descriptor->UniqueID == LINKWITZTRANSFORM || descriptor->UniqueID == MATRIXMIXER ? 1 : 0;
+  }
 }
 
 LADSPA_Handle BobDSPLadspa::Instantiate(const struct _LADSPA_Descriptor* Descriptor, unsigned long samplerate)
@@ -57,9 +93,13 @@ LADSPA_Handle BobDSPLadspa::Instantiate(const struct _LADSPA_Descriptor* Descrip
     return new CEchoCancellation(samplerate);
 #endif
   else if (Descriptor->UniqueID == NOISEMETERWEIGHTING)
-    return new CNoiseMeterWeighting(samplerate);
+    return new CNoiseMeterWeighting(samplerate, 1);
+  else if (Descriptor->UniqueID == NOISEMETERWEIGHTING4)
+    return new CNoiseMeterWeighting(samplerate, NMW_MAXCHANNELS);
   else if (Descriptor->UniqueID == NOISEMETERDETECT)
-    return new CNoiseMeterDetect(samplerate);
+    return new CNoiseMeterDetect(samplerate, false);
+  else if (Descriptor->UniqueID == NOISEMETERDETECTCONTROL)
+    return new CNoiseMeterDetect(samplerate, true);
   else if (Descriptor->UniqueID == SWITCH)
     return new CSwitch(samplerate);
   else if (Descriptor->UniqueID == PWM)
@@ -70,6 +110,22 @@ LADSPA_Handle BobDSPLadspa::Instantiate(const struct _LADSPA_Descriptor* Descrip
     return new CHilbertTransformPlugin();
   else if (Descriptor->UniqueID == DISTANCEDELAY)
     return new CDistanceDelay(samplerate);
+  else if (Descriptor->UniqueID == CONVOLVER)
+    return new CConvolver(samplerate);
+  else if (Descriptor->UniqueID == PARAMETRICEQ)
+    return new CParametricEq(samplerate);
+  else if (Descriptor->UniqueID == CROSSOVER)
+    return new CCrossover(samplerate);
+  else if (Descriptor->UniqueID == LIMITER)
+    return new CLimiterPlugin(samplerate);
+  else if (Descriptor->UniqueID == LOUDNESS)
+    return new CLoudness(samplerate);
+  else if (Descriptor->UniqueID == SPECTRUM)
+    return new CSpectrum(samplerate);
+  else if (Descriptor->UniqueID == MATRIXMIXER)
+    return new CMatrixMixer(samplerate);
+  else if (Descriptor->UniqueID == COMPRESSOR)
+    return new CCompressor(samplerate);
   else
     return NULL;
 }
@@ -36,6 +36,19 @@ namespace BobDSPLadspa
       virtual void Activate() = 0;
       virtual void Run(unsigned long samplecount) = 0;
       virtual void Deactivate() = 0;
+
+      //returns true when the audio outputs are equal to the audio inputs with the current controls
+      virtual bool IsIdentity() { return false; }
+
+      //called instead of Run() when the host skipped running the filter
+      virtual void Skipped() {}
+
+      //blocks until the work started in other threads for the current controls is done, not called from the realtime thread
+      virtual void WaitLoaded() {}
+
+      //the realtime priority of the thread that calls Run(), or -1 when it's not realtime,
+      //this can change between calls to Run(), see BOBDSP_SET_RT_PRIORITY
+      virtual void SetRealtimePriority(int priority) {}
   };
 }
 
@@ -23,6 +23,7 @@
 #include <stdlib.h>
 
 #define GAIN 1.570483967e+00
+#define INVGAIN ((float)(1.0 / GAIN))
 
 //coefficients generated using http://www-users.cs.york.ac.uk/~fisher/mkfilter/hilbert.html
 //this causes a 90 degree phase lag for all frequencies, it also acts as a high pass filter with the -3db point at about 70 hertz with a sample rate of 48 khz
@@ -164,68 +165,194 @@ using namespace BobDSPLadspa;
 
 CHilbertTransform::CHilbertTransform()
 {
-  m_bufindex = 0;
-  for (int i = 0; i < 2; i++)
-  {
-    m_buf[i] = (float*)aligned_alloc(ALIGN, BUFSIZE * sizeof(float));
-    memset(m_buf[i], 0, BUFSIZE * sizeof(float));
-  }
+  m_bufpos = 0;
+  m_usefft = false;
+  m_buf    = (float*)aligned_alloc(ALIGN, HISTSIZE * 2 * sizeof(float));
+  memset(m_buf, 0, HISTSIZE * 2 * sizeof(float));
 }
 
 CHilbertTransform::~CHilbertTransform()
 {
-  for (int i = 0; i < 2; i++)
-    free(m_buf[i]);
+  free(m_buf);
 }
 
 void CHilbertTransform::Reset()
 {
-  for (int i = 0; i < 2; i++)
-    memset(m_buf[i], 0, BUFSIZE * sizeof(float));
+  memset(m_buf, 0, HISTSIZE * 2 * sizeof(float));
+  m_bufpos = 0;
+  m_fft.Reset();
 }
 
-float OPTIMIZE CHilbertTransform::Process(float in)
+void CHilbertTransform::SetLength(int length)
 {
-  //move all samples back one position, and store the new sample
-  memmove(m_buf[m_bufindex], m_buf[m_bufindex] + 1, (BUFSIZE - 1) * sizeof(float));
-  m_buf[m_bufindex][BUFSIZE - 1] = in / GAIN;
+  bool usefft = CHilbertTransformFFT::RoundLength(length) > FILTERSIZE;
+  if (usefft)
+  {
+    //the fft convolution resets itself when its length changes
+    if (!m_usefft && m_fft.Length() == CHilbertTransformFFT::RoundLength(length))
+      m_fft.Reset();
 
-  //change the buffer for the current filter run
-  m_bufindex = !m_bufindex;
+    m_fft.SetLength(length);
+  }
+  else if (m_usefft)
+  {
+    //the history of the FIR filter is old, clear it
+    memset(m_buf, 0, HISTSIZE * 2 * sizeof(float));
+    m_bufpos = 0;
+  }
 
-  //pick the buffer to use, because the FIR filter only uses every other sample
-  //the input samples are stored across two buffers
-  float* bufptr = m_buf[m_bufindex];
-  float* bufend = bufptr + BUFSIZE;
-  const float* coeffsptr = g_coeffs;
+  m_usefft = usefft;
+}
 
-  float sum;
-#ifdef USE_SSE
-  ssevec sumvec;
-  sumvec.v = _mm_setzero_ps();
+//the FIR filter only uses every other sample, y[n] = sum(c[k] * x[n - 1 - 2 * (BUFSIZE - 1 - k)])
+//because the coefficients are antisymmetric, c[k] == -c[BUFSIZE - 1 - k], every pair of coefficients
+//only needs one multiply: y[n] = sum(c[k] * (x[n - FILTERSIZE + 1 + 2 * k] - x[n - 1 - 2 * k])) for k < BUFSIZE / 2
+//the vector loops calculate consecutive output samples, with the same coefficient in every lane,
+//hist points to the first sample of the block in the history of every channel
+//
+//every channel uses two sums, so that the additions don't have to wait on each other,
+//with more channels more additions run at the same time, and they share the coefficients
+template <int channels>
+static void OPTIMIZE FilterBlock(const float* const* hist, float* const* out, int samples)
+{
+  int i = 0;
 
-  ssevec samples;
-  ssevec coeffs;
-  while (bufptr != bufend)
+#ifdef __AVX__
+  for (; i + 8 <= samples; i += 8)
   {
-    samples.v = _mm_load_ps(bufptr);    //load 4 samples
-    coeffs.v  = _mm_load_ps(coeffsptr); //load 4 coefficients
+    __m256 sum[channels][2];
+    for (int c = 0; c < channels; c++)
+      sum[c][0] = sum[c][1] = _mm256_setzero_ps();
 
-    //multiply the 4 samples with the 4 coefficients, and add them to sumvec
-    sumvec.v  = _mm_add_ps(sumvec.v, _mm_mul_ps(samples.v, coeffs.v));
+    for (int k = 0; k < BUFSIZE / 2; k += 2)
+    {
+      for (int j = 0; j < 2; j++)
+      {
+        __m256 coef = _mm256_set1_ps(g_coeffs[k + j]);
+        for (int c = 0; c < channels; c++)
+        {
+          const float* x = hist[c] + i;
+          __m256 diff = _mm256_sub_ps(_mm256_loadu_ps(x - FILTERSIZE + 1 + 2 * (k + j)),
+                                      _mm256_loadu_ps(x - 1 - 2 * (k + j)));
+          sum[c][j] = _mm256_add_ps(sum[c][j], _mm256_mul_ps(coef, diff));
+        }
+      }
+    }
 
-    bufptr    += 4;
-    coeffsptr += 4;
+    for (int c = 0; c < channels; c++)
+      _mm256_storeu_ps(out[c] + i, _mm256_mul_ps(_mm256_add_ps(sum[c][0], sum[c][1]), _mm256_set1_ps(INVGAIN)));
   }
+#endif
 
-  sum = sumvec.f[0] + sumvec.f[1] + sumvec.f[2] + sumvec.f[3];
-#else
-  //apply the FIR filter
-  sum = 0.0f;
-  while (bufptr != bufend)
-    sum += *(coeffsptr++) * *(bufptr++);
+#ifdef USE_SSE
+  for (; i + 4 <= samples; i += 4)
+  {
+    __m128 sum[channels][2];
+    for (int c = 0; c < channels; c++)
+      sum[c][0] = sum[c][1] = _mm_setzero_ps();
+
+    for (int k = 0; k < BUFSIZE / 2; k += 2)
+    {
+      for (int j = 0; j < 2; j++)
+      {
+        __m128 coef = _mm_set1_ps(g_coeffs[k + j]);
+        for (int c = 0; c < channels; c++)
+        {
+          const float* x = hist[c] + i;
+          __m128 diff = _mm_sub_ps(_mm_loadu_ps(x - FILTERSIZE + 1 + 2 * (k + j)),
+                                   _mm_loadu_ps(x - 1 - 2 * (k + j)));
+          sum[c][j] = _mm_add_ps(sum[c][j], _mm_mul_ps(coef, diff));
+        }
+      }
+    }
+
+    for (int c = 0; c < channels; c++)
+      _mm_storeu_ps(out[c] + i, _mm_mul_ps(_mm_add_ps(sum[c][0], sum[c][1]), _mm_set1_ps(INVGAIN)));
+  }
 #endif
 
-  return sum;
+  for (; i < samples; i++)
+  {
+    for (int c = 0; c < channels; c++)
+    {
+      const float* x = hist[c] + i;
+      float sum = 0.0f;
+      for (int k = 0; k < BUFSIZE / 2; k++)
+        sum += g_coeffs[k] * (x[-FILTERSIZE + 1 + 2 * k] - x[-1 - 2 * k]);
+
+      out[c][i] = sum * INVGAIN;
+    }
+  }
+}
+
+void CHilbertTransform::Process(const float* in, float* out, float* delayed, int samples)
+{
+  if (m_usefft)
+  {
+    m_fft.Process(in, out, delayed, samples);
+    return;
+  }
+
+  while (samples > 0)
+  {
+    int block = samples < MAXBLOCK ? samples : MAXBLOCK;
+    const float* hist = StoreBlock(in, block);
+    FilterBlock<1>(&hist, &out, block);
+
+    //the filter delay is half the filter size
+    if (delayed)
+      memcpy(delayed, hist - BUFSIZE, block * sizeof(float));
+
+    in      += block;
+    out     += block;
+    samples -= block;
+    if (delayed)
+      delayed += block;
+  }
 }
 
+void CHilbertTransform::ProcessPair(CHilbertTransform* transforms, const float* const* in, float* const* out, int samples)
+{
+  if (transforms[0].m_usefft || transforms[1].m_usefft)
+  {
+    for (int c = 0; c < 2; c++)
+      transforms[c].Process(in[c], out[c], NULL, samples);
+    return;
+  }
+
+  for (int start = 0; start < samples; start += MAXBLOCK)
+  {
+    int block = samples - start < MAXBLOCK ? samples - start : MAXBLOCK;
+
+    const float* hist[2];
+    float*       blockout[2];
+    for (int c = 0; c < 2; c++)
+    {
+      hist[c]     = transforms[c].StoreBlock(in[c] + start, block);
+      blockout[c] = out[c] + start;
+    }
+
+    FilterBlock<2>(hist, blockout, block);
+  }
+}
+
+//stores the input samples in both halves of the history buffer, and returns a pointer to the
+//first sample of this block in the upper half, from there the FILTERSIZE samples before
+//every sample in this block can be read
+const float* CHilbertTransform::StoreBlock(const float* in, int samples)
+{
+  //a block wraps around the end of the history at most once
+  int first = samples < HISTSIZE - m_bufpos ? samples : HISTSIZE - m_bufpos;
+  memcpy(m_buf + m_bufpos, in, first * sizeof(float));
+  memcpy(m_buf + m_bufpos + HISTSIZE, in, first * sizeof(float));
+  memcpy(m_buf, in + first, (samples - first) * sizeof(float));
+  memcpy(m_buf + HISTSIZE, in + first, (samples - first) * sizeof(float));
+
+  int pos = m_bufpos + samples;
+  if (pos >= HISTSIZE)
+    pos -= HISTSIZE;
+  m_bufpos = pos;
+
+  int lastpos = pos == 0 ? HISTSIZE - 1 : pos - 1;
+  return m_buf + HISTSIZE + lastpos - (samples - 1);
+}
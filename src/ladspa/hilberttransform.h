@@ -19,9 +19,18 @@
 #ifndef HILBERTTRANSFORM_H
 #define HILBERTTRANSFORM_H
 
+#include "hilberttransformfft.h"
+
 #define FILTERSIZE 512
 #define BUFSIZE (FILTERSIZE / 2)
 
+//the history of input samples is a circular buffer of HISTSIZE samples, every sample
+//is stored twice, HISTSIZE apart, so that any FILTERSIZE samples can be read back without wrapping
+//a block of input samples is stored before the output is calculated, so the maximum block size
+//is the part of the history that's not needed by the filter
+#define HISTSIZE  (FILTERSIZE * 2)
+#define MAXBLOCK  (HISTSIZE - FILTERSIZE)
+
 namespace BobDSPLadspa
 {
   class CHilbertTransform
@@ -30,11 +39,31 @@ namespace BobDSPLadspa
       CHilbertTransform();
       ~CHilbertTransform();
       void  Reset();
-      float Process(float in);
+
+      //sets the filter length in taps, FILTERSIZE uses the FIR filter directly,
+      //longer filters use fft convolution, see CHilbertTransformFFT
+      void  SetLength(int length);
+      int   Length()  { return m_usefft ? m_fft.Length() : FILTERSIZE; }
+
+      //the delay of the output in samples
+      int   Latency() { return m_usefft ? m_fft.Latency() : BUFSIZE; }
+
+      //writes the hilbert transform of in to out, and the input delayed by
+      //the same amount as the hilbert transform to delayed, delayed may be NULL
+      //in may be the same buffer as out or delayed
+      void  Process(const float* in, float* out, float* delayed, int samples);
+
+      //runs two transforms on two channels, when both use the FIR filter it runs on both
+      //channels in one pass, in and out have a buffer for every channel
+      static void ProcessPair(CHilbertTransform* transforms, const float* const* in, float* const* out, int samples);
 
     private:
-      int          m_bufindex;
-      float*       m_buf[2];
+      const float* StoreBlock(const float* in, int samples);
+
+      int                  m_bufpos;
+      float*               m_buf;
+      bool                 m_usefft;
+      CHilbertTransformFFT m_fft;
   };
 }
 
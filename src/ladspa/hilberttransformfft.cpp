@@ -0,0 +1,271 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hilberttransformfft.h"
+#include "util/misc.h"
+#include "util/ssedefs.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace BobDSPLadspa;
+
+#define INPUTSIZE (HILBERTFFT_MAXLENGTH / 2 + HILBERTFFT_PARTITION * 2)
+#define FFTSIZE   (HILBERTFFT_PARTITION * 2)
+#define BINS      (HILBERTFFT_PARTITION + ALIGN / sizeof(float)) //fft size / 2 + 1, rounded up for the alignment
+#define MAXPARTS  (HILBERTFFT_MAXLENGTH / HILBERTFFT_PARTITION)
+
+//the filter lengths are the powers of two from HILBERTFFT_MINLENGTH to HILBERTFFT_MAXLENGTH
+#define NUMLENGTHS 5
+static_assert((HILBERTFFT_MINLENGTH << (NUMLENGTHS - 1)) == HILBERTFFT_MAXLENGTH, "NUMLENGTHS doesn't match the lengths");
+static_assert(HILBERTFFT_MINLENGTH % HILBERTFFT_PARTITION == 0, "the filter lengths have to be whole partitions");
+
+static int LengthIndex(int length)
+{
+  int index = 0;
+  while ((HILBERTFFT_MINLENGTH << index) < length)
+    index++;
+
+  return index;
+}
+
+//the spectra of the partitions of the filter kernels of every length, these are the same for every instance,
+//so they're made once, when the first instance is constructed, instead of in the realtime thread
+class CHilbertKernels
+{
+  public:
+    CHilbertKernels();
+    ~CHilbertKernels();
+
+    //BINS floats for every partition
+    float* m_re[NUMLENGTHS];
+    float* m_im[NUMLENGTHS];
+
+  private:
+    static void MakeKernel(CFFT& fft, float* kernel, float* time, int length, float* re, float* im);
+};
+
+CHilbertKernels::CHilbertKernels()
+{
+  CFFT   fft(FFTSIZE);
+  float* kernel = (float*)aligned_alloc(ALIGN, HILBERTFFT_MAXLENGTH * sizeof(float));
+  float* time   = (float*)aligned_alloc(ALIGN, FFTSIZE * sizeof(float));
+
+  for (int i = 0; i < NUMLENGTHS; i++)
+  {
+    int length = HILBERTFFT_MINLENGTH << i;
+    int size   = length / HILBERTFFT_PARTITION * BINS * sizeof(float);
+    m_re[i] = (float*)aligned_alloc(ALIGN, size);
+    m_im[i] = (float*)aligned_alloc(ALIGN, size);
+    MakeKernel(fft, kernel, time, length, m_re[i], m_im[i]);
+  }
+
+  free(kernel);
+  free(time);
+}
+
+CHilbertKernels::~CHilbertKernels()
+{
+  for (int i = 0; i < NUMLENGTHS; i++)
+  {
+    free(m_re[i]);
+    free(m_im[i]);
+  }
+}
+
+void CHilbertKernels::MakeKernel(CFFT& fft, float* kernel, float* time, int length, float* re, float* im)
+{
+  //the ideal hilbert transform is 2 / (pi * n) for odd n, and 0 for even n
+  //this is centered in the filter and windowed with a blackman window,
+  //the filter delays the signal by half its length
+  int    half = length / 2;
+  double gain = 0.0;
+  memset(kernel, 0, length * sizeof(float));
+  for (int n = 1; n < half; n += 2)
+  {
+    double window = 0.42 + 0.5 * cos(M_PI * n / half) + 0.08 * cos(2.0 * M_PI * n / half);
+    double coef   = 2.0 / (M_PI * n) * window;
+
+    kernel[half + n] = coef;
+    kernel[half - n] = -coef;
+
+    //the gain at a quarter of the sample rate, the window makes it a little lower than 1.0
+    gain += (n & 2) ? -coef * 2.0 : coef * 2.0;
+  }
+
+  //normalize the gain, and compensate for the gain of the inverse fft
+  float scale = 1.0 / (gain * HILBERTFFT_PARTITION);
+  for (int n = 0; n < length; n++)
+    kernel[n] *= scale;
+
+  //every partition is zero padded to the fft size
+  fft.SetSize(FFTSIZE);
+  memset(time + HILBERTFFT_PARTITION, 0, HILBERTFFT_PARTITION * sizeof(float));
+  for (int part = 0; part < length / HILBERTFFT_PARTITION; part++)
+  {
+    memcpy(time, kernel + part * HILBERTFFT_PARTITION, HILBERTFFT_PARTITION * sizeof(float));
+    fft.RealForward(time, re + part * BINS, im + part * BINS);
+  }
+}
+
+//the static is initialized on the first call, which is thread safe
+static const CHilbertKernels& Kernels()
+{
+  static CHilbertKernels kernels;
+  return kernels;
+}
+
+CHilbertTransformFFT::CHilbertTransformFFT() : m_fft(FFTSIZE)
+{
+  Kernels();
+  m_fft.SetSize(FFTSIZE);
+
+  m_specre   = (float*)aligned_alloc(ALIGN, BINS * sizeof(float));
+  m_specim   = (float*)aligned_alloc(ALIGN, BINS * sizeof(float));
+  m_inputre  = (float*)aligned_alloc(ALIGN, MAXPARTS * BINS * sizeof(float));
+  m_inputim  = (float*)aligned_alloc(ALIGN, MAXPARTS * BINS * sizeof(float));
+  m_input    = (float*)aligned_alloc(ALIGN, INPUTSIZE * sizeof(float));
+  m_output   = (float*)aligned_alloc(ALIGN, HILBERTFFT_PARTITION * sizeof(float));
+  m_time     = (float*)aligned_alloc(ALIGN, FFTSIZE * sizeof(float));
+
+  m_length = 0;
+  SetLength(HILBERTFFT_MINLENGTH);
+}
+
+CHilbertTransformFFT::~CHilbertTransformFFT()
+{
+  free(m_specre);
+  free(m_specim);
+  free(m_inputre);
+  free(m_inputim);
+  free(m_input);
+  free(m_output);
+  free(m_time);
+}
+
+int CHilbertTransformFFT::RoundLength(float length)
+{
+  int rounded = HILBERTFFT_MINLENGTH;
+  while (rounded < HILBERTFFT_MAXLENGTH && length >= rounded * M_SQRT2)
+    rounded *= 2;
+
+  return rounded;
+}
+
+void CHilbertTransformFFT::SetLength(int length)
+{
+  length = RoundLength(length);
+  if (length == m_length)
+    return;
+
+  m_length   = length;
+  m_parts    = length / HILBERTFFT_PARTITION;
+  m_kernelre = Kernels().m_re[LengthIndex(length)];
+  m_kernelim = Kernels().m_im[LengthIndex(length)];
+  Reset();
+}
+
+void CHilbertTransformFFT::Reset()
+{
+  memset(m_input, 0, INPUTSIZE * sizeof(float));
+  memset(m_output, 0, HILBERTFFT_PARTITION * sizeof(float));
+  memset(m_inputre, 0, MAXPARTS * BINS * sizeof(float));
+  memset(m_inputim, 0, MAXPARTS * BINS * sizeof(float));
+  m_pos     = 0;
+  m_specpos = 0;
+}
+
+void CHilbertTransformFFT::Process(const float* in, float* out, float* delayed, int samples)
+{
+  int half = m_length / 2;
+  while (samples > 0)
+  {
+    int block = Min(samples, HILBERTFFT_PARTITION - m_pos);
+
+    //store the input after the previous block, the output of the previous block is read back
+    //and the delayed input is read half the filter length before the previous block
+    memcpy(m_input + half + HILBERTFFT_PARTITION + m_pos, in, block * sizeof(float));
+    memcpy(out, m_output + m_pos, block * sizeof(float));
+    if (delayed)
+    {
+      memcpy(delayed, m_input + m_pos, block * sizeof(float));
+      delayed += block;
+    }
+
+    in      += block;
+    out     += block;
+    samples -= block;
+    m_pos   += block;
+
+    if (m_pos == HILBERTFFT_PARTITION)
+    {
+      ProcessBlock();
+      m_pos = 0;
+    }
+  }
+}
+
+void OPTIMIZE CHilbertTransformFFT::ProcessBlock()
+{
+  int half = m_length / 2;
+
+  //transform the previous and current block, and keep the spectrum for the next blocks
+  float* inputre = m_inputre + m_specpos * BINS;
+  float* inputim = m_inputim + m_specpos * BINS;
+  m_fft.RealForward(m_input + half, inputre, inputim);
+
+  //partition p of the filter is multiplied with the spectrum of p blocks ago
+  memset(m_specre, 0, BINS * sizeof(float));
+  memset(m_specim, 0, BINS * sizeof(float));
+  for (int part = 0; part < m_parts; part++)
+  {
+    int          spec = m_specpos - part < 0 ? m_specpos - part + m_parts : m_specpos - part;
+    const float* xre  = m_inputre + spec * BINS;
+    const float* xim  = m_inputim + spec * BINS;
+    const float* hre  = m_kernelre + part * BINS;
+    const float* him  = m_kernelim + part * BINS;
+
+    int k = 0;
+#ifdef USE_SSE
+    for (; k < HILBERTFFT_PARTITION; k += 4)
+    {
+      __m128 xr = _mm_load_ps(xre + k);
+      __m128 xi = _mm_load_ps(xim + k);
+      __m128 hr = _mm_load_ps(hre + k);
+      __m128 hi = _mm_load_ps(him + k);
+      _mm_store_ps(m_specre + k, _mm_add_ps(_mm_load_ps(m_specre + k), _mm_sub_ps(_mm_mul_ps(xr, hr), _mm_mul_ps(xi, hi))));
+      _mm_store_ps(m_specim + k, _mm_add_ps(_mm_load_ps(m_specim + k), _mm_add_ps(_mm_mul_ps(xr, hi), _mm_mul_ps(xi, hr))));
+    }
+#endif
+    for (; k <= HILBERTFFT_PARTITION; k++)
+    {
+      m_specre[k] += xre[k] * hre[k] - xim[k] * him[k];
+      m_specim[k] += xre[k] * him[k] + xim[k] * hre[k];
+    }
+  }
+
+  m_specpos = m_specpos + 1 == m_parts ? 0 : m_specpos + 1;
+
+  m_fft.RealInverse(m_specre, m_specim, m_time);
+
+  //the first half of the result is aliased by the circular convolution, the second half is the filter output
+  memcpy(m_output, m_time + HILBERTFFT_PARTITION, HILBERTFFT_PARTITION * sizeof(float));
+
+  //move the current block into the place of the previous block
+  memmove(m_input, m_input + HILBERTFFT_PARTITION, (half + HILBERTFFT_PARTITION) * sizeof(float));
+}
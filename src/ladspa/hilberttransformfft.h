@@ -0,0 +1,79 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HILBERTTRANSFORMFFT_H
+#define HILBERTTRANSFORMFFT_H
+
+#include "fft.h"
+
+#define HILBERTFFT_MINLENGTH 512
+#define HILBERTFFT_MAXLENGTH 8192
+
+//the filter is split into partitions of this many taps, which is also the block size
+#define HILBERTFFT_PARTITION 512
+
+namespace BobDSPLadspa
+{
+  //hilbert transform with a long FIR filter, done with uniformly partitioned overlap-save fft convolution
+  //the filter is split into partitions of HILBERTFFT_PARTITION taps, the input is processed in blocks
+  //of that size, with an fft of twice the block size, the spectra of the previous blocks are kept,
+  //and every block the output spectrum is the sum of those multiplied with the spectra of the partitions,
+  //so the work per block doesn't grow with the filter length like with one fft over the whole filter,
+  //this adds a delay of one block to the delay of half the filter length of the filter itself
+  class CHilbertTransformFFT
+  {
+    public:
+      CHilbertTransformFFT();
+      ~CHilbertTransformFFT();
+
+      //rounds length to a power of two between HILBERTFFT_MINLENGTH and HILBERTFFT_MAXLENGTH
+      static int RoundLength(float length);
+
+      //sets the filter length in taps, when it changes the filter is reset,
+      //the kernels of every length are made when the first instance is constructed,
+      //so this only selects one and can be called from the realtime thread
+      void SetLength(int length);
+      int  Length()  { return m_length; }
+      int  Latency() { return m_length / 2 + HILBERTFFT_PARTITION; }
+
+      void Reset();
+
+      //same as CHilbertTransform::Process()
+      void Process(const float* in, float* out, float* delayed, int samples);
+
+    private:
+      void ProcessBlock();
+
+      CFFT         m_fft;
+      int          m_length;
+      int          m_parts;    //number of partitions of the filter
+      int          m_pos;
+      int          m_specpos;  //partition in m_inputre and m_inputim the current block goes in
+      const float* m_kernelre; //spectra of the partitions of the filter kernel of the current length
+      const float* m_kernelim;
+      float* m_input;   //half the filter length for the delayed output, the previous block and the current block
+      float* m_output;  //filtered samples of the previous block
+      float* m_inputre; //spectra of the last m_parts blocks
+      float* m_inputim;
+      float* m_specre;
+      float* m_specim;
+      float* m_time;
+  };
+}
+
+#endif //HILBERTTRANSFORMFFT_H
@@ -0,0 +1,133 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hilberttransformiir.h"
+#include <string.h>
+
+using namespace BobDSPLadspa;
+
+//coefficients from http://yehar.com/blog/?p=368
+//every stage is a second order allpass filter y[n] = a^2 * (x[n] + y[n - 2]) - x[n - 2]
+static const float g_refcoefs[IIRSTAGES] =
+{
+  0.4021921162426f, 0.8561710882420f, 0.9722909545651f, 0.9952884791278f
+};
+
+//the output of this cascade is delayed by one sample
+static const float g_quadcoefs[IIRSTAGES] =
+{
+  0.6923878000000f, 0.9360654322959f, 0.9882295226860f, 0.9987488452737f
+};
+
+CHilbertTransformIIR::CHilbertTransformIIR()
+{
+  for (int s = 0; s < IIRSTAGES; s++)
+  {
+    float ref  = g_refcoefs[s] * g_refcoefs[s];
+    float quad = g_quadcoefs[s] * g_quadcoefs[s];
+
+#ifdef USE_SSE
+    m_coefs[s] = _mm_setr_ps(ref, quad, ref, quad);
+#else
+    for (int l = 0; l < IIRLANES; l++)
+      m_coefs[s][l] = (l & 1) ? quad : ref;
+#endif
+  }
+
+  Reset();
+}
+
+CHilbertTransformIIR::~CHilbertTransformIIR()
+{
+}
+
+void CHilbertTransformIIR::Reset()
+{
+#ifdef USE_SSE
+  for (int s = 0; s < IIRSTAGES; s++)
+    m_x1[s] = m_x2[s] = m_y1[s] = m_y2[s] = _mm_setzero_ps();
+
+  m_prev = _mm_setzero_ps();
+#else
+  memset(m_x1, 0, sizeof(m_x1));
+  memset(m_x2, 0, sizeof(m_x2));
+  memset(m_y1, 0, sizeof(m_y1));
+  memset(m_y2, 0, sizeof(m_y2));
+  memset(m_prev, 0, sizeof(m_prev));
+#endif
+}
+
+void OPTIMIZE CHilbertTransformIIR::Process(const float* const* in, float* const* out, int samples)
+{
+#ifdef USE_SSE
+  //selects the reference lanes from the current output, and the quadrature lanes from the previous output
+  ssevec mask;
+  mask.i[0] = mask.i[2] = 0xFFFFFFFF;
+  mask.i[1] = mask.i[3] = 0;
+
+  for (int i = 0; i < samples; i++)
+  {
+    ssevec x;
+    for (int l = 0; l < IIRLANES; l++)
+      x.f[l] = in[l] ? in[l][i] : 0.0f;
+
+    for (int s = 0; s < IIRSTAGES; s++)
+    {
+      __m128 y = _mm_sub_ps(_mm_mul_ps(m_coefs[s], _mm_add_ps(x.v, m_y2[s])), m_x2[s]);
+      m_x2[s] = m_x1[s];
+      m_x1[s] = x.v;
+      m_y2[s] = m_y1[s];
+      m_y1[s] = y;
+      x.v = y;
+    }
+
+    ssevec y;
+    y.v    = _mm_or_ps(_mm_and_ps(mask.v, x.v), _mm_andnot_ps(mask.v, m_prev));
+    m_prev = x.v;
+
+    for (int l = 0; l < IIRLANES; l++)
+    {
+      if (out[l])
+        out[l][i] = y.f[l];
+    }
+  }
+#else
+  for (int i = 0; i < samples; i++)
+  {
+    for (int l = 0; l < IIRLANES; l++)
+    {
+      float x = in[l] ? in[l][i] : 0.0f;
+      for (int s = 0; s < IIRSTAGES; s++)
+      {
+        float y = m_coefs[s][l] * (x + m_y2[s][l]) - m_x2[s][l];
+        m_x2[s][l] = m_x1[s][l];
+        m_x1[s][l] = x;
+        m_y2[s][l] = m_y1[s][l];
+        m_y1[s][l] = y;
+        x = y;
+      }
+
+      float y = (l & 1) ? m_prev[l] : x;
+      m_prev[l] = x;
+
+      if (out[l])
+        out[l][i] = y;
+    }
+  }
+#endif
+}
@@ -0,0 +1,65 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HILBERTTRANSFORMIIR_H
+#define HILBERTTRANSFORMIIR_H
+
+#include "util/ssedefs.h"
+
+#define IIRSTAGES 4
+#define IIRLANES  4
+
+namespace BobDSPLadspa
+{
+  //phase difference network made from two cascades of allpass filters, designed by Olli Niemitalo
+  //the output of the quadrature cascade lags the output of the reference cascade by 90 degrees
+  //from about 20 hertz to 20 kilohertz at 48 khz, with almost no latency
+  //
+  //four cascades run in the lanes of an sse vector, even lanes are reference cascades
+  //and odd lanes are quadrature cascades, so one instance can do both cascades for two channels
+  class CHilbertTransformIIR
+  {
+    public:
+      CHilbertTransformIIR();
+      ~CHilbertTransformIIR();
+
+      void Reset();
+
+      //in and out have a buffer for every lane, a NULL input is silence and a NULL output is not written
+      void Process(const float* const* in, float* const* out, int samples);
+
+    private:
+#ifdef USE_SSE
+      __m128 m_coefs[IIRSTAGES];
+      __m128 m_x1[IIRSTAGES];
+      __m128 m_x2[IIRSTAGES];
+      __m128 m_y1[IIRSTAGES];
+      __m128 m_y2[IIRSTAGES];
+      __m128 m_prev;
+#else
+      float  m_coefs[IIRSTAGES][IIRLANES];
+      float  m_x1[IIRSTAGES][IIRLANES];
+      float  m_x2[IIRSTAGES][IIRLANES];
+      float  m_y1[IIRSTAGES][IIRLANES];
+      float  m_y2[IIRSTAGES][IIRLANES];
+      float  m_prev[IIRLANES];
+#endif
+  };
+}
+
+#endif //HILBERTTRANSFORMIIR_H
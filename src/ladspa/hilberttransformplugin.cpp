@@ -17,6 +17,7 @@
  */
 
 #include "hilberttransformplugin.h"
+#include "util/misc.h"
 
 #include <string.h>
 #include <algorithm>
@@ -27,8 +28,7 @@ using namespace BobDSPLadspa;
 CHilbertTransformPlugin::CHilbertTransformPlugin()
 {
   memset(m_ports, 0, sizeof(m_ports));
-  memset(m_delaybuf, 0, sizeof(m_delaybuf));
-  m_delaybufpos = 0;
+  m_lowlatency = false;
 }
 
 CHilbertTransformPlugin::~CHilbertTransformPlugin()
@@ -42,14 +42,33 @@ void CHilbertTransformPlugin::ConnectPort(unsigned long port, LADSPA_Data* datal
 
 void CHilbertTransformPlugin::Activate()
 {
-  memset(m_delaybuf, 0, sizeof(m_delaybuf));
-  m_delaybufpos = 0;
   for (int i = 0; i < HT_NUMCHANNELS; i++)
     m_hilberttransform[i].Reset();
+
+  m_hilbertiir.Reset();
 }
 
 void CHilbertTransformPlugin::Run(unsigned long samplecount)
 {
+  for (int c = 0; c < HT_NUMCHANNELS; c++)
+    m_hilberttransform[c].SetLength(Round32(*m_ports[HT_FILTERLENGTH]));
+
+  //when switching between the FIR and IIR filters, clear the old state of the one that's used next
+  bool lowlatency = Round32(*m_ports[HT_LOWLATENCY]) != 0;
+  if (lowlatency != m_lowlatency)
+  {
+    m_lowlatency = lowlatency;
+    if (lowlatency)
+    {
+      m_hilbertiir.Reset();
+    }
+    else
+    {
+      for (int c = 0; c < HT_NUMCHANNELS; c++)
+        m_hilberttransform[c].Reset();
+    }
+  }
+
   LADSPA_Data dryratio[HT_NUMCHANNELS];
   LADSPA_Data wetratio[HT_NUMCHANNELS] = {*(m_ports[HT_LEFT_DRYWET]), *(m_ports[HT_RIGHT_DRYWET])};
   for (int c = 0; c < HT_NUMCHANNELS; c++)
@@ -65,31 +84,36 @@ void CHilbertTransformPlugin::Run(unsigned long samplecount)
     wetratio[c] *= gain;
   }
 
-  LADSPA_Data in[HT_NUMCHANNELS];
-  LADSPA_Data out[HT_NUMCHANNELS];
-  for (unsigned long i = 0; i < samplecount; i++)
+  //process in blocks, the hilbert transform also returns its input with the same delay as the wet signal,
+  //which is used as the dry signal, in low latency mode the dry signal is the reference output of the
+  //allpass cascades, and the wet signal is the quadrature output
+  LADSPA_Data wet[HT_NUMCHANNELS][MAXBLOCK];
+  LADSPA_Data dry[HT_NUMCHANNELS][MAXBLOCK];
+  for (unsigned long i = 0; i < samplecount; i += MAXBLOCK)
   {
-    //read input samples
-    in[HT_LEFT_CHAN]  = m_ports[HT_LEFT_IN][i];
-    in[HT_RIGHT_CHAN] = m_ports[HT_RIGHT_IN][i];
+    int block = std::min(samplecount - i, (unsigned long)MAXBLOCK);
 
-    for (int c = 0; c < HT_NUMCHANNELS; c++)
+    //run the hilbert transforms for both channels before writing the output, in case an output port
+    //uses the same buffer as the input port of the other channel
+    if (lowlatency)
     {
-      //get the wet sample from the hilbert transform, and the dry sample from the delay buffer
-      //the delay buffer is neede because the hilbert transform causes a delay of half its filter length
-      out[c] = m_hilberttransform[c].Process(in[c]) * wetratio[c] + m_delaybuf[c][m_delaybufpos] * dryratio[c];
-
-      //write the new input sample into the delay buffer
-      m_delaybuf[c][m_delaybufpos] = in[c];
+      const float* in[IIRLANES] = { m_ports[HT_LEFT_IN] + i, m_ports[HT_LEFT_IN] + i,
+                                    m_ports[HT_RIGHT_IN] + i, m_ports[HT_RIGHT_IN] + i };
+      float* out[IIRLANES] = { dry[HT_LEFT_CHAN], wet[HT_LEFT_CHAN], dry[HT_RIGHT_CHAN], wet[HT_RIGHT_CHAN] };
+      m_hilbertiir.Process(in, out, block);
+    }
+    else
+    {
+      for (int c = 0; c < HT_NUMCHANNELS; c++)
+        m_hilberttransform[c].Process(m_ports[HT_LEFT_IN + c] + i, wet[c], dry[c], block);
     }
 
-    m_delaybufpos++;
-    if (m_delaybufpos >= FILTERSIZE / 2)
-      m_delaybufpos = 0;
-
-    //write output samples
-    m_ports[HT_LEFT_OUT][i]  = out[HT_LEFT_CHAN];
-    m_ports[HT_RIGHT_OUT][i] = out[HT_RIGHT_CHAN];
+    for (int c = 0; c < HT_NUMCHANNELS; c++)
+    {
+      LADSPA_Data* out = m_ports[HT_LEFT_OUT + c] + i;
+      for (int j = 0; j < block; j++)
+        out[j] = wet[c][j] * wetratio[c] + dry[c][j] * dryratio[c];
+    }
   }
 }
 
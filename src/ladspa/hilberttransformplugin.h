@@ -23,6 +23,7 @@
 #include "filterinterface.h"
 
 #include "hilberttransform.h"
+#include "hilberttransformiir.h"
 
 #define HT_LEFT_IN      0
 #define HT_RIGHT_IN     1
@@ -30,8 +31,10 @@
 #define HT_RIGHT_OUT    3
 #define HT_LEFT_DRYWET  4
 #define HT_RIGHT_DRYWET 5
+#define HT_FILTERLENGTH 6
+#define HT_LOWLATENCY   7
 
-#define HT_NUMPORTS     6
+#define HT_NUMPORTS     8
 #define HT_NUMCHANNELS  2
 
 #define HT_LEFT_CHAN    0
@@ -51,10 +54,10 @@ namespace BobDSPLadspa
       void Deactivate();
 
     private:
-      LADSPA_Data*      m_ports[HT_NUMPORTS];
-      CHilbertTransform m_hilberttransform[HT_NUMCHANNELS];
-      LADSPA_Data       m_delaybuf[HT_NUMCHANNELS][FILTERSIZE / 2];
-      int               m_delaybufpos;
+      LADSPA_Data*         m_ports[HT_NUMPORTS];
+      CHilbertTransform    m_hilberttransform[HT_NUMCHANNELS];
+      CHilbertTransformIIR m_hilbertiir;
+      bool                 m_lowlatency;
   };
 }
 #endif //HILBERTTRANSFORMPLUGIN_H
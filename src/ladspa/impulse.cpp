@@ -0,0 +1,284 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impulse.h"
+#include "fft.h"
+#include "util/inclstdint.h"
+#include "util/misc.h"
+#include "util/ssedefs.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+using namespace BobDSPLadspa;
+using namespace std;
+
+std::map<std::string, CImpulse*> CImpulse::m_cache;
+pthread_mutex_t                  CImpulse::m_cachemutex = PTHREAD_MUTEX_INITIALIZER;
+
+//reads the whole file into memory
+static uint8_t* ReadFile(const std::string& filename, int& size)
+{
+  FILE* file = fopen(filename.c_str(), "rb");
+  if (!file)
+    return NULL;
+
+  uint8_t* data = NULL;
+  if (fseek(file, 0, SEEK_END) == 0)
+  {
+    long filesize = ftell(file);
+    if (filesize > 0 && fseek(file, 0, SEEK_SET) == 0)
+    {
+      data = (uint8_t*)malloc(filesize);
+      if (fread(data, 1, filesize, file) == (size_t)filesize)
+      {
+        size = filesize;
+      }
+      else
+      {
+        free(data);
+        data = NULL;
+      }
+    }
+  }
+
+  fclose(file);
+  return data;
+}
+
+static inline uint32_t ReadLE(const uint8_t* data, int bytes)
+{
+  uint32_t value = 0;
+  for (int i = 0; i < bytes; i++)
+    value |= (uint32_t)data[i] << (i * 8);
+
+  return value;
+}
+
+CImpulse* CImpulse::Acquire(const std::string& filename)
+{
+  pthread_mutex_lock(&m_cachemutex);
+
+  CImpulse* impulse = NULL;
+  map<string, CImpulse*>::iterator it = m_cache.find(filename);
+  if (it != m_cache.end())
+  {
+    impulse = it->second;
+    impulse->m_refcount++;
+  }
+  else
+  {
+    float* samples;
+    int    length;
+    bool   loaded;
+    if (filename.length() >= 4 && filename.compare(filename.length() - 4, 4, ".wav") == 0)
+      loaded = LoadWav(filename, samples, length);
+    else
+      loaded = LoadRaw(filename, samples, length);
+
+    if (loaded)
+    {
+      impulse = new CImpulse(filename, samples, length);
+      m_cache[filename] = impulse;
+      free(samples);
+    }
+  }
+
+  pthread_mutex_unlock(&m_cachemutex);
+
+  return impulse;
+}
+
+void CImpulse::Release(CImpulse* impulse)
+{
+  if (!impulse)
+    return;
+
+  pthread_mutex_lock(&m_cachemutex);
+
+  impulse->m_refcount--;
+  if (impulse->m_refcount == 0)
+  {
+    m_cache.erase(impulse->m_filename);
+    delete impulse;
+  }
+
+  pthread_mutex_unlock(&m_cachemutex);
+}
+
+int CImpulse::BinStride(int level)
+{
+  //blocksize + 1 bins, rounded up for the alignment
+  return g_convblocksize[level] + ALIGN / sizeof(float);
+}
+
+CImpulse::CImpulse(const std::string& filename, float* samples, int length)
+{
+  m_filename = filename;
+  m_refcount = 1;
+  m_length   = Min(length, CONV_MAXLENGTH);
+
+  m_head = (float*)aligned_alloc(ALIGN, CONV_HEADSIZE * sizeof(float));
+  memset(m_head, 0, CONV_HEADSIZE * sizeof(float));
+  memcpy(m_head, samples, Min(m_length, CONV_HEADSIZE) * sizeof(float));
+
+  for (int level = 0; level < CONV_LEVELS; level++)
+  {
+    int blocksize = g_convblocksize[level];
+    int start     = g_convoffset[level];
+    int end       = level + 1 < CONV_LEVELS ? g_convoffset[level + 1] : CONV_MAXLENGTH;
+    end = Min(end, m_length);
+
+    m_partitions[level] = start < end ? (end - start + blocksize - 1) / blocksize : 0;
+    m_kernelre[level]   = NULL;
+    m_kernelim[level]   = NULL;
+    if (m_partitions[level] == 0)
+      continue;
+
+    int stride = BinStride(level);
+    m_kernelre[level] = (float*)aligned_alloc(ALIGN, m_partitions[level] * stride * sizeof(float));
+    m_kernelim[level] = (float*)aligned_alloc(ALIGN, m_partitions[level] * stride * sizeof(float));
+    memset(m_kernelre[level], 0, m_partitions[level] * stride * sizeof(float));
+    memset(m_kernelim[level], 0, m_partitions[level] * stride * sizeof(float));
+
+    //every partition is zero padded to twice the block size for overlap-save
+    //the inverse fft multiplies by the block size, compensate for that here
+    CFFT   fft(blocksize * 2);
+    float* time = (float*)aligned_alloc(ALIGN, blocksize * 2 * sizeof(float));
+    for (int p = 0; p < m_partitions[level]; p++)
+    {
+      int first = start + p * blocksize;
+      int taps  = Min(blocksize, end - first);
+
+      memset(time, 0, blocksize * 2 * sizeof(float));
+      for (int i = 0; i < taps; i++)
+        time[i] = samples[first + i] / blocksize;
+
+      fft.RealForward(time, m_kernelre[level] + p * stride, m_kernelim[level] + p * stride);
+    }
+    free(time);
+  }
+}
+
+CImpulse::~CImpulse()
+{
+  free(m_head);
+  for (int level = 0; level < CONV_LEVELS; level++)
+  {
+    free(m_kernelre[level]);
+    free(m_kernelim[level]);
+  }
+}
+
+bool CImpulse::LoadWav(const std::string& filename, float*& samples, int& length)
+{
+  int      size;
+  uint8_t* data = ReadFile(filename, size);
+  if (!data)
+    return false;
+
+  if (size < 12 || memcmp(data, "RIFF", 4) != 0 || memcmp(data + 8, "WAVE", 4) != 0)
+  {
+    free(data);
+    return false;
+  }
+
+  int format   = 0;
+  int channels = 0;
+  int bits     = 0;
+  samples = NULL;
+
+  //walk the chunks, the fmt chunk has to come before the data chunk
+  int pos = 12;
+  while (pos + 8 <= size && !samples)
+  {
+    int chunksize = ReadLE(data + pos + 4, 4);
+    const uint8_t* chunk = data + pos + 8;
+    if (chunksize < 0 || chunksize > size - pos - 8)
+      chunksize = size - pos - 8;
+
+    if (memcmp(data + pos, "fmt ", 4) == 0 && chunksize >= 16)
+    {
+      format   = ReadLE(chunk, 2);
+      channels = ReadLE(chunk + 2, 2);
+      bits     = ReadLE(chunk + 14, 2);
+
+      //WAVE_FORMAT_EXTENSIBLE, the format is in the first two bytes of the subformat guid
+      if (format == 0xFFFE && chunksize >= 26)
+        format = ReadLE(chunk + 24, 2);
+    }
+    else if (memcmp(data + pos, "data", 4) == 0 && channels > 0)
+    {
+      bool pcm  = format == 1 && (bits == 16 || bits == 24 || bits == 32);
+      bool ieee  = format == 3 && bits == 32;
+      if (!pcm && !ieee)
+        break;
+
+      //only the first channel is used
+      int bytes = bits / 8;
+      int frame = bytes * channels;
+      length  = chunksize / frame;
+      samples = (float*)malloc(Max(length, 1) * sizeof(float));
+      for (int i = 0; i < length; i++)
+      {
+        uint32_t value = ReadLE(chunk + i * frame, bytes);
+        if (ieee)
+        {
+          memcpy(samples + i, &value, sizeof(float));
+        }
+        else
+        {
+          //shift the sample up to 32 bits, so that the sign is correct
+          int32_t ivalue = (int32_t)(value << (32 - bits));
+          samples[i] = (float)ivalue / 2147483648.0f;
+        }
+      }
+    }
+
+    pos += 8 + chunksize + (chunksize & 1);
+  }
+
+  free(data);
+
+  if (samples && length == 0)
+  {
+    free(samples);
+    samples = NULL;
+  }
+
+  return samples != NULL;
+}
+
+bool CImpulse::LoadRaw(const std::string& filename, float*& samples, int& length)
+{
+  //raw files are mono 32 bits floats in native byte order
+  int      size;
+  uint8_t* data = ReadFile(filename, size);
+  if (!data)
+    return false;
+
+  length = size / sizeof(float);
+  if (length == 0)
+  {
+    free(data);
+    return false;
+  }
+
+  samples = (float*)data;
+  return true;
+}
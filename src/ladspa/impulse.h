@@ -0,0 +1,80 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef IMPULSE_H
+#define IMPULSE_H
+
+#include <string>
+#include <map>
+#include <pthread.h>
+
+//the impulse response is split into a head that's convolved directly, and levels of
+//uniform partitions that are convolved with fft, the block size increases with every level
+//the first level runs in the realtime thread, its output for a block is calculated when the previous block
+//is complete, so it starts one block into the impulse response
+//the other levels run in a thread, which gets one block of time to do its work, so they start two blocks in
+#define CONV_HEADSIZE  64
+#define CONV_LEVELS    3
+#define CONV_MAXLENGTH 262144
+
+const int g_convblocksize[CONV_LEVELS] = { 64, 1024, 8192 };
+const int g_convoffset[CONV_LEVELS]    = { 64, 2048, 16384 };
+
+namespace BobDSPLadspa
+{
+  //an impulse response loaded from a file, with the spectra of its partitions
+  //instances that use the same file share it through a cache
+  class CImpulse
+  {
+    public:
+      //returns the impulse response of the file, it's loaded when it's not in the cache
+      //returns NULL when the file can't be loaded
+      static CImpulse* Acquire(const std::string& filename);
+      static void      Release(CImpulse* impulse);
+
+      int          Length()               { return m_length;             }
+      const float* Head()                 { return m_head;               }
+      int          Partitions(int level)  { return m_partitions[level];  }
+      static int   BinStride(int level);
+
+      //the spectrum of every partition is BinStride() floats after the previous one,
+      //the spectra are scaled to compensate for the gain of the inverse fft
+      const float* KernelRe(int level)    { return m_kernelre[level];    }
+      const float* KernelIm(int level)    { return m_kernelim[level];    }
+
+    private:
+      CImpulse(const std::string& filename, float* samples, int length);
+      ~CImpulse();
+
+      static bool LoadWav(const std::string& filename, float*& samples, int& length);
+      static bool LoadRaw(const std::string& filename, float*& samples, int& length);
+
+      std::string m_filename;
+      int         m_refcount;
+      int         m_length;
+      float*      m_head;
+      int         m_partitions[CONV_LEVELS];
+      float*      m_kernelre[CONV_LEVELS];
+      float*      m_kernelim[CONV_LEVELS];
+
+      static std::map<std::string, CImpulse*> m_cache;
+      static pthread_mutex_t                  m_cachemutex;
+  };
+}
+
+#endif //IMPULSE_H
@@ -0,0 +1,346 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "limiter.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+float CLimiter::m_linkreduction[LIMITER_MAXGROUPS][LIMITER_MAXMEMBERS];
+int   CLimiter::m_linkused[LIMITER_MAXGROUPS][LIMITER_MAXMEMBERS];
+
+CLimiter::CLimiter(int samplerate, int channels)
+{
+  m_samplerate  = samplerate;
+  m_channels    = Clamp(channels, 1, LIMITER_MAXCHANNELS);
+  m_lookahead   = 1;
+  m_delay       = 0;
+  m_releasecoef = 1.0f;
+  m_release     = 0.0f;
+  m_ceiling     = 1.0f;
+  m_truepeak    = false;
+  m_initialized = false;
+  m_group       = 0;
+  m_member      = -1;
+  m_time        = 0;
+  m_lowestgain  = 1.0f;
+
+  //allocate everything for the longest look-ahead time, so that changing it doesn't allocate memory
+  int maxlookahead = (int)ceilf(LIMITER_MAXLOOKAHEAD * samplerate) + 1;
+
+  m_delaysize = 1;
+  while (m_delaysize < maxlookahead + TP_LATENCY + LIMITER_BLOCK)
+    m_delaysize *= 2;
+
+  for (int c = 0; c < m_channels; c++)
+    m_delaybuf[c] = new float[m_delaysize];
+
+  m_dequesize = maxlookahead + 1;
+  m_dequegain = new float[m_dequesize];
+  m_dequetime = new uint32_t[m_dequesize];
+  m_avgbuf    = new float[maxlookahead];
+
+  Reset();
+}
+
+CLimiter::~CLimiter()
+{
+  SetLinkGroup(0);
+
+  for (int c = 0; c < m_channels; c++)
+    delete[] m_delaybuf[c];
+
+  delete[] m_dequegain;
+  delete[] m_dequetime;
+  delete[] m_avgbuf;
+}
+
+void CLimiter::SetParameters(float lookahead, float release, float ceiling, bool truepeak)
+{
+  int maxlookahead = m_dequesize - 1;
+  int samples      = Clamp(Round32(lookahead * m_samplerate), 1, maxlookahead);
+
+  if (samples != m_lookahead || truepeak != m_truepeak || !m_initialized)
+  {
+    m_lookahead   = samples;
+    m_truepeak    = truepeak;
+    m_delay       = m_lookahead - 1 + (m_truepeak ? TP_LATENCY : 0);
+    m_initialized = true;
+    Reset();
+  }
+
+  //the gain moves exponentially back to 1 after a peak, release is the time constant
+  if (release != m_release)
+  {
+    m_release     = release;
+    m_releasecoef = 1.0f - expf(-1.0f / Max(release * m_samplerate, 1.0f));
+  }
+
+  m_ceiling = Max(ceiling, 1e-6f);
+}
+
+void CLimiter::Reset()
+{
+  for (int c = 0; c < m_channels; c++)
+  {
+    memset(m_delaybuf[c], 0, m_delaysize * sizeof(float));
+    m_truepeakdet[c].Reset();
+  }
+
+  m_dequefront = 0;
+  m_dequecount = 0;
+
+  for (int i = 0; i < m_lookahead; i++)
+    m_avgbuf[i] = 1.0f;
+
+  m_avgsum     = m_lookahead;
+  m_avgpos     = 0;
+  m_gain       = 1.0f;
+  m_lowestgain = 1.0f;
+  m_unity      = m_lookahead;
+}
+
+void CLimiter::SetLinkGroup(int group)
+{
+  group = Clamp(group, 0, LIMITER_MAXGROUPS);
+  if (group == m_group)
+    return;
+
+  //leave the old group
+  if (m_member != -1)
+  {
+    PublishReduction(1.0f);
+    __atomic_store_n(m_linkused[m_group - 1] + m_member, 0, __ATOMIC_RELEASE);
+    m_member = -1;
+  }
+
+  m_group = 0;
+  if (group == 0)
+    return;
+
+  //claim a free place in the new group, without locking, since this is called from the realtime thread
+  for (int i = 0; i < LIMITER_MAXMEMBERS; i++)
+  {
+    int unused = 0;
+    if (__atomic_compare_exchange_n(m_linkused[group - 1] + i, &unused, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      m_group  = group;
+      m_member = i;
+      PublishReduction(1.0f);
+      break;
+    }
+  }
+}
+
+//the highest gain reduction of the other members of the group, from their last processed block,
+//members that run before this one in the same period are up to date, the others are one period late
+float CLimiter::GroupGain()
+{
+  if (m_member == -1)
+    return 1.0f;
+
+  float reduction = 0.0f;
+  for (int i = 0; i < LIMITER_MAXMEMBERS; i++)
+  {
+    if (i != m_member && __atomic_load_n(m_linkused[m_group - 1] + i, __ATOMIC_ACQUIRE))
+    {
+      float member;
+      __atomic_load(m_linkreduction[m_group - 1] + i, &member, __ATOMIC_RELAXED);
+      reduction = Max(reduction, member);
+    }
+  }
+
+  return 1.0f - reduction;
+}
+
+void CLimiter::PublishReduction(float gain)
+{
+  if (m_member != -1)
+  {
+    float reduction = 1.0f - gain;
+    __atomic_store(m_linkreduction[m_group - 1] + m_member, &reduction, __ATOMIC_RELAXED);
+  }
+}
+
+void CLimiter::Process(const float* const* in, float* const* out, int samples)
+{
+  m_lowestgain = 1.0f;
+
+  float groupgain = GroupGain();
+  float ownlowest = 1.0f;
+
+  for (int i = 0; i < samples; i += LIMITER_BLOCK)
+  {
+    int block = Min(samples - i, LIMITER_BLOCK);
+
+    const float* blockin[LIMITER_MAXCHANNELS];
+    float*       blockout[LIMITER_MAXCHANNELS];
+    for (int c = 0; c < m_channels; c++)
+    {
+      blockin[c]  = in[c] ? in[c] + i : NULL;
+      blockout[c] = out[c] ? out[c] + i : NULL;
+    }
+
+    ownlowest = Min(ownlowest, ProcessBlock(blockin, blockout, block, groupgain));
+  }
+
+  PublishReduction(ownlowest);
+}
+
+//returns the lowest gain needed by the peaks of this limiter's own channels
+float OPTIMIZE CLimiter::ProcessBlock(const float* const* in, float* const* out, int samples, float groupgain)
+{
+  //find the peak of every sample over all channels, the true peak detector is TP_LATENCY samples late
+  float peak[LIMITER_BLOCK];
+  memset(peak, 0, samples * sizeof(float));
+  for (int c = 0; c < m_channels; c++)
+  {
+    if (!in[c])
+      continue;
+
+    if (m_truepeak)
+    {
+      m_truepeakdet[c].Process(in[c], peak, samples);
+    }
+    else
+    {
+      for (int i = 0; i < samples; i++)
+        peak[i] = Max(peak[i], fabsf(in[c][i]));
+    }
+  }
+
+  //store the input in the delay lines before writing any output, in case an output buffer is an input buffer,
+  //a block wraps around the end of a delay line at most once
+  int mask     = m_delaysize - 1;
+  int writepos = m_time & mask;
+  int readpos  = (m_time - m_delay) & mask;
+  int writelen = Min(samples, m_delaysize - writepos);
+  int readlen  = Min(samples, m_delaysize - readpos);
+  for (int c = 0; c < m_channels; c++)
+  {
+    if (in[c])
+    {
+      memcpy(m_delaybuf[c] + writepos, in[c], writelen * sizeof(float));
+      memcpy(m_delaybuf[c], in[c] + writelen, (samples - writelen) * sizeof(float));
+    }
+  }
+
+  //when the gain has been 1 for the whole look-ahead time, and no peak in this block goes over the ceiling,
+  //the gain stays 1 for the whole block, then the deque only keeps the newest gain of 1,
+  //the moving average only contains gains of 1, and the delayed input is copied to the output
+  float blockpeak = 0.0f;
+  for (int i = 0; i < samples; i++)
+    blockpeak = Max(blockpeak, peak[i]);
+
+  if (m_unity >= m_lookahead && groupgain >= 1.0f && blockpeak <= m_ceiling)
+  {
+    m_dequefront   = 0;
+    m_dequecount   = 1;
+    m_dequegain[0] = 1.0f;
+    m_dequetime[0] = m_time + samples - 1;
+    m_avgpos       = (m_avgpos + samples) % m_lookahead;
+
+    for (int c = 0; c < m_channels; c++)
+    {
+      if (in[c] && out[c])
+      {
+        memcpy(out[c], m_delaybuf[c] + readpos, readlen * sizeof(float));
+        memcpy(out[c] + readlen, m_delaybuf[c], (samples - readlen) * sizeof(float));
+      }
+    }
+
+    m_time += samples;
+
+    return 1.0f;
+  }
+
+  float gain[LIMITER_BLOCK];
+  float ownlowest = 1.0f;
+  float invlookahead = 1.0f / m_lookahead;
+  for (int i = 0; i < samples; i++)
+  {
+    uint32_t time = m_time + i;
+    float    need = peak[i] > m_ceiling ? m_ceiling / peak[i] : 1.0f;
+
+    //remove the gains from the back that are not lower than the new one, since they
+    //will never be the minimum again, then add the new one
+    while (m_dequecount > 0 && m_dequegain[(m_dequefront + m_dequecount - 1) % m_dequesize] >= need)
+      m_dequecount--;
+
+    int back = (m_dequefront + m_dequecount) % m_dequesize;
+    m_dequegain[back] = need;
+    m_dequetime[back] = time;
+    m_dequecount++;
+
+    //remove the front when it's older than the look-ahead time
+    if (time - m_dequetime[m_dequefront] >= (uint32_t)m_lookahead)
+    {
+      m_dequefront = (m_dequefront + 1) % m_dequesize;
+      m_dequecount--;
+    }
+
+    float minimum = m_dequegain[m_dequefront];
+    ownlowest = Min(ownlowest, minimum);
+
+    //the gain goes down immediately, and back up with the release time,
+    //close to 1 it's set to 1, since the release would only get there in steps of float precision
+    float release = m_gain + (1.0f - m_gain) * m_releasecoef;
+    if (release > LIMITER_UNITY)
+      release = 1.0f;
+
+    m_gain = Min(Min(minimum, groupgain), release);
+
+    //moving average over the look-ahead time
+    m_avgsum += m_gain - m_avgbuf[m_avgpos];
+    m_avgbuf[m_avgpos] = m_gain;
+    if (++m_avgpos == m_lookahead)
+      m_avgpos = 0;
+
+    //once the gain has been 1 for the whole look-ahead time, the moving average is exactly 1
+    if (m_gain < 1.0f)
+    {
+      m_unity = 0;
+    }
+    else if (m_unity < m_lookahead && ++m_unity == m_lookahead)
+    {
+      m_avgsum = m_lookahead;
+    }
+
+    gain[i] = Min((float)m_avgsum * invlookahead, 1.0f);
+    m_lowestgain = Min(m_lowestgain, gain[i]);
+  }
+
+  for (int c = 0; c < m_channels; c++)
+  {
+    if (in[c] && out[c])
+    {
+      const float* delayed = m_delaybuf[c] + readpos;
+      for (int i = 0; i < readlen; i++)
+        out[c][i] = delayed[i] * gain[i];
+
+      for (int i = readlen; i < samples; i++)
+        out[c][i] = m_delaybuf[c][i - readlen] * gain[i];
+    }
+  }
+
+  m_time += samples;
+
+  return ownlowest;
+}
@@ -0,0 +1,115 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIMITER_H
+#define LIMITER_H
+
+#include "util/inclstdint.h"
+#include "truepeak.h"
+
+#define LIMITER_MAXCHANNELS  8
+#define LIMITER_BLOCK        256
+#define LIMITER_MAXLOOKAHEAD 0.02f
+#define LIMITER_UNITY        0.999999f //gains above this go to 1
+
+//instances of CLimiter with the same link group use the highest gain reduction of all of them
+#define LIMITER_MAXGROUPS    16
+#define LIMITER_MAXMEMBERS   32
+
+namespace BobDSPLadspa
+{
+  //look-ahead limiter, the input is delayed by the look-ahead time, and the gain is lowered
+  //smoothly during that time so that it reaches the needed reduction when the peak arrives
+  //
+  //for every sample the needed gain is calculated from the peak of all channels, then the
+  //lowest needed gain within the look-ahead time is found with a monotonic deque, the release
+  //is applied to that, and a moving average with the length of the look-ahead time
+  //makes the gain curve smooth, since the average of values that are all lower than
+  //the needed gain is lower than the needed gain too, the output never goes over the ceiling
+  class CLimiter
+  {
+    public:
+      CLimiter(int samplerate, int channels);
+      ~CLimiter();
+
+      //lookahead and release are in seconds, ceiling is linear
+      //changing the look-ahead time or the true peak detection resets the limiter
+      void SetParameters(float lookahead, float release, float ceiling, bool truepeak);
+
+      //0 is not linked, 1 to LIMITER_MAXGROUPS joins that group
+      void SetLinkGroup(int group);
+
+      void Reset();
+      int  Latency() { return m_delay; }
+
+      //in and out have a buffer for every channel, an output buffer may be the same as any
+      //input buffer, channels with a NULL input are skipped
+      void Process(const float* const* in, float* const* out, int samples);
+
+      //lowest gain of the last call to Process()
+      float LowestGain() { return m_lowestgain; }
+
+    private:
+      float ProcessBlock(const float* const* in, float* const* out, int samples, float groupgain);
+      void  PublishReduction(float gain);
+      float GroupGain();
+
+      int        m_samplerate;
+      int        m_channels;
+      int        m_lookahead; //length of the sliding minimum and the moving average, in samples
+      int        m_delay;     //delay of the audio, in samples
+      float      m_releasecoef;
+      float      m_ceiling;
+      bool       m_truepeak;
+      bool       m_initialized;
+
+      CTruePeak  m_truepeakdet[LIMITER_MAXCHANNELS];
+
+      //audio delay line of every channel, indexed by sample number modulo m_delaysize
+      float*     m_delaybuf[LIMITER_MAXCHANNELS];
+      int        m_delaysize;
+
+      //monotonic deque of needed gains, with the sample number that each gain belongs to,
+      //values increase from the front to the back, so the front is the minimum
+      float*     m_dequegain;
+      uint32_t*  m_dequetime;
+      int        m_dequesize;
+      int        m_dequefront;
+      int        m_dequecount;
+
+      //moving average of the gain after the release
+      float*     m_avgbuf;
+      int        m_avgpos;
+      double     m_avgsum;
+
+      uint32_t   m_time;
+      float      m_gain;      //gain after the release
+      int        m_unity;     //number of samples that m_gain has been 1, up to m_lookahead
+      float      m_release;
+      float      m_lowestgain;
+
+      int        m_group;
+      int        m_member;
+
+      //gain reduction of every member of every group, 0 means no reduction
+      static float m_linkreduction[LIMITER_MAXGROUPS][LIMITER_MAXMEMBERS];
+      static int   m_linkused[LIMITER_MAXGROUPS][LIMITER_MAXMEMBERS];
+  };
+}
+
+#endif //LIMITER_H
@@ -0,0 +1,69 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "limiterplugin.h"
+#include "util/misc.h"
+
+#include <string.h>
+#include <math.h>
+
+using namespace BobDSPLadspa;
+
+CLimiterPlugin::CLimiterPlugin(unsigned long samplerate) : m_limiter(samplerate, LIM_NUMCHANNELS)
+{
+  memset(m_ports, 0, sizeof(m_ports));
+  m_ceilingdb = 0.0f;
+  m_ceiling   = 1.0f;
+}
+
+CLimiterPlugin::~CLimiterPlugin()
+{
+}
+
+void CLimiterPlugin::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CLimiterPlugin::Activate()
+{
+  m_limiter.Reset();
+}
+
+void CLimiterPlugin::Run(unsigned long samplecount)
+{
+  if (*m_ports[LIM_CEILING] != m_ceilingdb)
+  {
+    m_ceilingdb = *m_ports[LIM_CEILING];
+    m_ceiling   = powf(10.0f, m_ceilingdb / 20.0f);
+  }
+
+  m_limiter.SetLinkGroup(Round32(*m_ports[LIM_LINKGROUP]));
+  m_limiter.SetParameters(Round32(*m_ports[LIM_LOOKAHEAD]) / 1000.0f, *m_ports[LIM_RELEASE] / 1000.0f,
+                          m_ceiling, Round32(*m_ports[LIM_TRUEPEAK]) != 0);
+
+  const float* in[LIM_NUMCHANNELS]  = { m_ports[LIM_LEFT_IN], m_ports[LIM_RIGHT_IN] };
+  float*       out[LIM_NUMCHANNELS] = { m_ports[LIM_LEFT_OUT], m_ports[LIM_RIGHT_OUT] };
+  m_limiter.Process(in, out, samplecount);
+
+  *m_ports[LIM_REDUCTION] = -20.0f * log10f(m_limiter.LowestGain());
+}
+
+void CLimiterPlugin::Deactivate()
+{
+}
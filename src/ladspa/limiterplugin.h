@@ -0,0 +1,61 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LIMITERPLUGIN_H
+#define LIMITERPLUGIN_H
+
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+#include "limiter.h"
+
+#define LIM_LEFT_IN    0
+#define LIM_RIGHT_IN   1
+#define LIM_LEFT_OUT   2
+#define LIM_RIGHT_OUT  3
+#define LIM_LOOKAHEAD  4
+#define LIM_RELEASE    5
+#define LIM_CEILING    6
+#define LIM_TRUEPEAK   7
+#define LIM_LINKGROUP  8
+#define LIM_REDUCTION  9
+
+#define LIM_NUMPORTS   10
+#define LIM_NUMCHANNELS 2
+
+namespace BobDSPLadspa
+{
+  class CLimiterPlugin : public IFilter
+  {
+    public:
+      CLimiterPlugin(unsigned long samplerate);
+      ~CLimiterPlugin();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+
+    private:
+      LADSPA_Data* m_ports[LIM_NUMPORTS];
+      CLimiter     m_limiter;
+      LADSPA_Data  m_ceilingdb;
+      float        m_ceiling;
+  };
+}
+
+#endif //LIMITERPLUGIN_H
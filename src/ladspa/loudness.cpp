@@ -0,0 +1,336 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "loudness.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+//weight of the surround channels, +1.5 dB
+#define LOUD_SURROUNDWEIGHT 1.41f
+
+static double Loudness(double energy)
+{
+  if (energy <= 0.0)
+    return LOUD_FLOOR;
+  else
+    return Max(-0.691 + 10.0 * log10(energy), (double)LOUD_FLOOR);
+}
+
+CLoudness::CLoudness(unsigned long samplerate)
+{
+  memset(m_ports, 0, sizeof(m_ports));
+  memset(m_state, 0, sizeof(m_state));
+  m_channels  = 0;
+  m_reset     = false;
+  m_blocksize = Max(Round32(samplerate * LOUD_BLOCKTIME), 1);
+
+  //the K-weighting filter from ITU-R BS.1770 is specified at 48 KHz, these are the analog
+  //prototypes of its two sections, transformed with the bilinear transform for any sample rate
+  //first a high shelf of about +4 dB to model the acoustic effect of the head
+  double K  = tan(M_PI * 1681.974450955533 / samplerate);
+  double Q  = 0.7071752369554196;
+  double Vh = pow(10.0, 3.999843853973347 / 20.0);
+  double Vb = pow(Vh, 0.4996667741545416);
+  double a0 = 1.0 + K / Q + K * K;
+  m_coefs[0][0] = (Vh + Vb * K / Q + K * K) / a0;
+  m_coefs[0][1] = 2.0 * (K * K - Vh) / a0;
+  m_coefs[0][2] = (Vh - Vb * K / Q + K * K) / a0;
+  m_coefs[0][3] = -2.0 * (K * K - 1.0) / a0;
+  m_coefs[0][4] = -(1.0 - K / Q + K * K) / a0;
+
+  //then the revised low-frequency B-curve, a second order highpass at 38 Hz
+  K  = tan(M_PI * 38.13547087602444 / samplerate);
+  Q  = 0.5003270373238773;
+  a0 = 1.0 + K / Q + K * K;
+  m_coefs[1][0] = 1.0;
+  m_coefs[1][1] = -2.0;
+  m_coefs[1][2] = 1.0;
+  m_coefs[1][3] = -2.0 * (K * K - 1.0) / a0;
+  m_coefs[1][4] = -(1.0 - K / Q + K * K) / a0;
+
+  ResetMeasurement();
+}
+
+CLoudness::~CLoudness()
+{
+}
+
+void CLoudness::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CLoudness::Activate()
+{
+  memset(m_state, 0, sizeof(m_state));
+  ResetMeasurement();
+}
+
+void CLoudness::Deactivate()
+{
+}
+
+void CLoudness::SetChannels(int channels)
+{
+  if (channels == m_channels)
+    return;
+
+  //a group of channels that wasn't used has an old state
+  for (int group = (m_channels + LOUD_LANES - 1) / LOUD_LANES; group < LOUD_GROUPS; group++)
+    memset(m_state[group], 0, sizeof(m_state[group]));
+
+  m_channels = channels;
+
+  //the channel order is L R C Ls Rs for 5 channels, and L R C LFE Ls Rs Lb Rb for 6 to 8 channels,
+  //the LFE channel is not measured, and the surround channels are weighted +1.5 dB
+  for (int channel = 0; channel < LOUD_MAXCHANNELS; channel++)
+  {
+    float weight;
+    if (channel >= m_channels)
+      weight = 0.0f;
+    else if (m_channels == 5 && channel >= 3)
+      weight = LOUD_SURROUNDWEIGHT;
+    else if (m_channels >= 6 && channel == 3)
+      weight = 0.0f;
+    else if (m_channels >= 6 && channel >= 4)
+      weight = LOUD_SURROUNDWEIGHT;
+    else
+      weight = 1.0f;
+
+    m_weights[channel / LOUD_LANES][channel % LOUD_LANES] = weight;
+  }
+}
+
+void CLoudness::ResetMeasurement()
+{
+  m_blockleft    = m_blocksize;
+  m_blockenergy  = 0.0;
+  m_blockpos     = 0;
+  m_nrblocks     = 0;
+  m_momentarysum = 0.0;
+  m_shorttermsum = 0.0;
+  m_gatedcount   = 0;
+  m_gatedenergy  = 0.0;
+  m_truepeak     = 0.0f;
+  m_momentary    = LOUD_FLOOR;
+  m_shortterm    = LOUD_FLOOR;
+  m_integrated   = LOUD_FLOOR;
+  memset(m_blocks, 0, sizeof(m_blocks));
+  memset(m_histcount, 0, sizeof(m_histcount));
+  memset(m_histenergy, 0, sizeof(m_histenergy));
+
+  for (int channel = 0; channel < LOUD_MAXCHANNELS; channel++)
+    m_truepeakdet[channel].Reset();
+}
+
+void CLoudness::Run(unsigned long samplecount)
+{
+  SetChannels(Clamp(Round32(*m_ports[LOUD_CHANNELS]), 1, LOUD_MAXCHANNELS));
+
+  //the measurement restarts when the reset control is turned on
+  bool reset = *m_ports[LOUD_RESET] > 0.5f;
+  if (reset && !m_reset)
+    ResetMeasurement();
+  m_reset = reset;
+
+  unsigned long i = 0;
+  while (i < samplecount)
+  {
+    int samples = Min(Min((int)(samplecount - i), LOUD_CHUNK), m_blockleft);
+    RunChunk(i, samples);
+
+    i           += samples;
+    m_blockleft -= samples;
+    if (m_blockleft == 0)
+      EndBlock();
+  }
+
+  *m_ports[LOUD_MOMENTARY]  = m_momentary;
+  *m_ports[LOUD_SHORTTERM]  = m_shortterm;
+  *m_ports[LOUD_INTEGRATED] = m_integrated;
+  if (m_truepeak > 0.0f)
+    *m_ports[LOUD_TRUEPEAK] = Max(20.0f * log10f(m_truepeak), LOUD_FLOOR);
+  else
+    *m_ports[LOUD_TRUEPEAK] = LOUD_FLOOR;
+}
+
+void OPTIMIZE CLoudness::RunChunk(int offset, int samples)
+{
+  static const float silence[LOUD_CHUNK] = {};
+
+  for (int group = 0; group * LOUD_LANES < m_channels; group++)
+  {
+    const float* in[LOUD_LANES];
+    for (int lane = 0; lane < LOUD_LANES; lane++)
+    {
+      int channel = group * LOUD_LANES + lane;
+      in[lane] = channel < m_channels ? m_ports[LOUD_IN1 + channel] + offset : silence;
+    }
+
+#ifdef USE_SSE
+    //both sections and the squaring run in one pass, with coefficients and state in registers
+    __m128 b00 = _mm_set1_ps(m_coefs[0][0]);
+    __m128 b01 = _mm_set1_ps(m_coefs[0][1]);
+    __m128 b02 = _mm_set1_ps(m_coefs[0][2]);
+    __m128 a01 = _mm_set1_ps(m_coefs[0][3]);
+    __m128 a02 = _mm_set1_ps(m_coefs[0][4]);
+    __m128 a11 = _mm_set1_ps(m_coefs[1][3]);
+    __m128 a12 = _mm_set1_ps(m_coefs[1][4]);
+    __m128 s01 = _mm_loadu_ps(m_state[group][0][0]);
+    __m128 s02 = _mm_loadu_ps(m_state[group][0][1]);
+    __m128 s11 = _mm_loadu_ps(m_state[group][1][0]);
+    __m128 s12 = _mm_loadu_ps(m_state[group][1][1]);
+    __m128 sum = _mm_setzero_ps();
+
+    for (int i = 0; i < samples; i++)
+    {
+      __m128 x = _mm_setr_ps(in[0][i], in[1][i], in[2][i], in[3][i]);
+
+      __m128 y = _mm_add_ps(_mm_mul_ps(b00, x), s01);
+      s01 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(b01, x), _mm_mul_ps(a01, y)), s02);
+      s02 = _mm_add_ps(_mm_mul_ps(b02, x), _mm_mul_ps(a02, y));
+
+      //the highpass has b0 = 1, b1 = -2 and b2 = 1
+      x = y;
+      y = _mm_add_ps(x, s11);
+      s11 = _mm_add_ps(_mm_sub_ps(_mm_mul_ps(a11, y), _mm_add_ps(x, x)), s12);
+      s12 = _mm_add_ps(x, _mm_mul_ps(a12, y));
+
+      sum = _mm_add_ps(sum, _mm_mul_ps(y, y));
+    }
+
+    _mm_storeu_ps(m_state[group][0][0], s01);
+    _mm_storeu_ps(m_state[group][0][1], s02);
+    _mm_storeu_ps(m_state[group][1][0], s11);
+    _mm_storeu_ps(m_state[group][1][1], s12);
+
+    ssevec weighted;
+    weighted.v = _mm_mul_ps(sum, _mm_loadu_ps(m_weights[group]));
+    m_blockenergy += (double)weighted.f[0] + weighted.f[1] + weighted.f[2] + weighted.f[3];
+#else
+    for (int lane = 0; lane < LOUD_LANES; lane++)
+    {
+      if (m_weights[group][lane] == 0.0f)
+        continue;
+
+      float sum = 0.0f;
+      for (int i = 0; i < samples; i++)
+      {
+        float x = in[lane][i];
+        for (int section = 0; section < LOUD_SECTIONS; section++)
+        {
+          float* s = m_state[group][section][0] + lane;
+          float* c = m_coefs[section];
+          float  y = c[0] * x + s[0];
+          s[0] = c[1] * x + c[3] * y + s[LOUD_LANES];
+          s[LOUD_LANES] = c[2] * x + c[4] * y;
+          x = y;
+        }
+        sum += x * x;
+      }
+
+      m_blockenergy += sum * m_weights[group][lane];
+    }
+#endif
+  }
+
+  //the true peak is the highest of all channels, including the LFE channel
+  float peak[LOUD_CHUNK];
+  memset(peak, 0, samples * sizeof(float));
+  for (int channel = 0; channel < m_channels; channel++)
+    m_truepeakdet[channel].Process(m_ports[LOUD_IN1 + channel] + offset, peak, samples);
+
+  for (int i = 0; i < samples; i++)
+    m_truepeak = Max(m_truepeak, peak[i]);
+}
+
+void CLoudness::EndBlock()
+{
+  double energy = m_blockenergy / m_blocksize;
+  m_blockenergy = 0.0;
+  m_blockleft   = m_blocksize;
+
+  //m_blockpos is the oldest block in the ring, which leaves the short-term window,
+  //the block that leaves the momentary window is 4 blocks before the new one
+  int momentarypos = (m_blockpos + LOUD_SHORTTERMBLOCKS - LOUD_MOMENTARYBLOCKS) % LOUD_SHORTTERMBLOCKS;
+  m_momentarysum += energy - m_blocks[momentarypos];
+  m_shorttermsum += energy - m_blocks[m_blockpos];
+  m_blocks[m_blockpos] = energy;
+  m_blockpos = (m_blockpos + 1) % LOUD_SHORTTERMBLOCKS;
+  m_nrblocks++;
+
+  //recalculate the running sums once every pass through the ring, so rounding errors don't add up
+  if (m_blockpos == 0)
+  {
+    m_momentarysum = 0.0;
+    m_shorttermsum = 0.0;
+    for (int i = 0; i < LOUD_SHORTTERMBLOCKS; i++)
+    {
+      if (i >= LOUD_SHORTTERMBLOCKS - LOUD_MOMENTARYBLOCKS)
+        m_momentarysum += m_blocks[i];
+      m_shorttermsum += m_blocks[i];
+    }
+  }
+
+  double momentary = Max(m_momentarysum, 0.0) / LOUD_MOMENTARYBLOCKS;
+  m_momentary = Loudness(momentary);
+  m_shortterm = Loudness(Max(m_shorttermsum, 0.0) / LOUD_SHORTTERMBLOCKS);
+
+  //every 400 ms window, with 75% overlap, is a gating block
+  if (m_nrblocks >= LOUD_MOMENTARYBLOCKS)
+  {
+    double loudness = Loudness(momentary);
+    if (loudness >= LOUD_ABSGATE)
+    {
+      int bin = Min((int)((loudness - LOUD_ABSGATE) / LOUD_HISTSTEP), LOUD_HISTBINS - 1);
+      m_histcount[bin]++;
+      m_histenergy[bin] += momentary;
+      m_gatedcount++;
+      m_gatedenergy += momentary;
+
+      m_integrated = Integrated();
+    }
+  }
+}
+
+double CLoudness::Integrated()
+{
+  if (m_gatedcount == 0)
+    return LOUD_FLOOR;
+
+  //the relative gate is 10 LU below the loudness of all blocks above the absolute gate,
+  //the bins that start at or above the relative gate are used
+  double gate  = Loudness(m_gatedenergy / m_gatedcount) + LOUD_RELGATE;
+  int    start = Clamp((int)ceil((gate - LOUD_ABSGATE) / LOUD_HISTSTEP), 0, LOUD_HISTBINS - 1);
+
+  int64_t count  = 0;
+  double  energy = 0.0;
+  for (int bin = start; bin < LOUD_HISTBINS; bin++)
+  {
+    count  += m_histcount[bin];
+    energy += m_histenergy[bin];
+  }
+
+  if (count == 0)
+    return LOUD_FLOOR;
+  else
+    return Loudness(energy / count);
+}
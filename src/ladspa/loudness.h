@@ -0,0 +1,122 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef LOUDNESS_H
+#define LOUDNESS_H
+
+#include "util/inclstdint.h"
+#include "util/ssedefs.h"
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+#include "truepeak.h"
+
+#define LOUD_IN1        0
+#define LOUD_CHANNELS   8
+#define LOUD_RESET      9
+#define LOUD_MOMENTARY  10
+#define LOUD_SHORTTERM  11
+#define LOUD_INTEGRATED 12
+#define LOUD_TRUEPEAK   13
+#define LOUD_NUMPORTS   14
+
+#define LOUD_MAXCHANNELS 8
+#define LOUD_LANES       4
+#define LOUD_GROUPS      (LOUD_MAXCHANNELS / LOUD_LANES)
+#define LOUD_SECTIONS    2
+#define LOUD_CHUNK       256
+
+//the loudness is measured in blocks of 100 ms, momentary loudness is the mean of
+//the last 4 blocks, short-term loudness the mean of the last 30
+#define LOUD_BLOCKTIME   0.1
+#define LOUD_MOMENTARYBLOCKS 4
+#define LOUD_SHORTTERMBLOCKS 30
+
+//every 400 ms gating block above the absolute gate goes into a histogram with 0.1 LU bins,
+//blocks louder than the highest bin go into the highest bin
+#define LOUD_ABSGATE     -70.0
+#define LOUD_RELGATE     -10.0
+#define LOUD_HISTSTEP    0.1
+#define LOUD_HISTBINS    800
+
+//value of the outputs when there's nothing to measure
+#define LOUD_FLOOR       -120.0f
+
+namespace BobDSPLadspa
+{
+  //loudness meter according to ITU-R BS.1770 and EBU R128
+  //
+  //up to 8 channels are K-weighted with 4 channels in the lanes of an sse vector, the
+  //mean square of every channel is weighted and summed per 100 ms block, the momentary
+  //and short-term windows are running sums over a ring of block energies, and the gating
+  //for the integrated loudness is done on a histogram, so that the whole measurement
+  //doesn't have to be kept
+  class CLoudness : public IFilter
+  {
+    public:
+      CLoudness(unsigned long samplerate);
+      ~CLoudness();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+
+    private:
+      void   SetChannels(int channels);
+      void   ResetMeasurement();
+      void   RunChunk(int offset, int samples);
+      void   EndBlock();
+      double Integrated();
+
+      LADSPA_Data* m_ports[LOUD_NUMPORTS];
+      int          m_channels;
+      bool         m_reset;
+
+      //b0, b1, b2, a1 and a2 of the shelving filter and the highpass, a1 and a2 are negated
+      float        m_coefs[LOUD_SECTIONS][5];
+      //transposed direct form II state, for every channel group
+      float        m_state[LOUD_GROUPS][LOUD_SECTIONS][2][LOUD_LANES];
+      float        m_weights[LOUD_GROUPS][LOUD_LANES];
+
+      int          m_blocksize;
+      int          m_blockleft;
+      double       m_blockenergy;
+
+      //ring of the mean square of the last blocks, with running sums of the last 4 and 30
+      double       m_blocks[LOUD_SHORTTERMBLOCKS];
+      int          m_blockpos;
+      int64_t      m_nrblocks;
+      double       m_momentarysum;
+      double       m_shorttermsum;
+
+      //number and summed energy of the gating blocks in every bin
+      uint32_t     m_histcount[LOUD_HISTBINS];
+      double       m_histenergy[LOUD_HISTBINS];
+      int64_t      m_gatedcount;
+      double       m_gatedenergy;
+
+      CTruePeak    m_truepeakdet[LOUD_MAXCHANNELS];
+      float        m_truepeak;
+
+      float        m_momentary;
+      float        m_shortterm;
+      float        m_integrated;
+  };
+}
+
+#endif //LOUDNESS_H
@@ -0,0 +1,303 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "matrixmixer.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+CMatrixMixer::CMatrixMixer(unsigned long samplerate)
+{
+  m_rampsamples = Max(Round32(samplerate * MIX_RAMPTIME), 1);
+  memset(m_ports, 0, sizeof(m_ports));
+  memset(m_gain, 0, sizeof(m_gain));
+  memset(m_target, 0, sizeof(m_target));
+  memset(m_step, 0, sizeof(m_step));
+  memset(m_nractive, 0, sizeof(m_nractive));
+  m_ramping = false;
+  m_jump    = true;
+}
+
+CMatrixMixer::~CMatrixMixer()
+{
+}
+
+void CMatrixMixer::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CMatrixMixer::Activate()
+{
+  m_jump = true;
+}
+
+void CMatrixMixer::Deactivate()
+{
+}
+
+bool CMatrixMixer::IsIdentity()
+{
+  UpdateGains();
+
+  if (m_ramping)
+    return false;
+
+  //when every input goes to its own output, the host copies the inputs to the outputs
+  for (int out = 0; out < MIX_CHANNELS; out++)
+  {
+    for (int in = 0; in < MIX_CHANNELS; in++)
+    {
+      if (m_gain[out][in] != (in == out ? 1.0f : 0.0f))
+        return false;
+    }
+  }
+
+  return true;
+}
+
+void CMatrixMixer::UpdateGains()
+{
+  //when a gain changes, ramp linearly from the current gain to the new one
+  m_ramping = false;
+  for (int out = 0; out < MIX_CHANNELS; out++)
+  {
+    for (int in = 0; in < MIX_CHANNELS; in++)
+    {
+      float target = Clamp(*m_ports[MIX_GAINPORT(in, out)], -MIX_MAXGAIN, MIX_MAXGAIN);
+      if (target != m_target[out][in] || m_jump)
+      {
+        m_target[out][in] = target;
+        if (m_jump)
+        {
+          m_gain[out][in] = target;
+          m_step[out][in] = 0.0f;
+        }
+        else
+        {
+          m_step[out][in] = (target - m_gain[out][in]) / m_rampsamples;
+        }
+      }
+
+      if (m_step[out][in] != 0.0f)
+        m_ramping = true;
+    }
+  }
+
+  m_jump = false;
+
+  //only inputs that are heard, or will be, are mixed into an output
+  for (int out = 0; out < MIX_CHANNELS; out++)
+  {
+    m_nractive[out] = 0;
+    for (int in = 0; in < MIX_CHANNELS; in++)
+    {
+      if (m_gain[out][in] != 0.0f || m_target[out][in] != 0.0f)
+        m_active[out][m_nractive[out]++] = in;
+    }
+  }
+}
+
+void CMatrixMixer::Run(unsigned long samplecount)
+{
+  UpdateGains();
+
+  //mix a block of all inputs into every output, so the inputs are read from the cache
+  for (unsigned long offset = 0; offset < samplecount; offset += MIX_BLOCK)
+  {
+    int samples = Min((int)(samplecount - offset), MIX_BLOCK);
+    for (int out = 0; out < MIX_CHANNELS; out++)
+      MixOutput(out, offset, samples);
+
+    if (m_ramping)
+      AdvanceRamps(samples);
+  }
+}
+
+void CMatrixMixer::AdvanceRamps(int samples)
+{
+  m_ramping = false;
+  for (int out = 0; out < MIX_CHANNELS; out++)
+  {
+    for (int in = 0; in < MIX_CHANNELS; in++)
+    {
+      float step = m_step[out][in];
+      if (step == 0.0f)
+        continue;
+
+      float gain = m_gain[out][in] + step * samples;
+      if ((step > 0.0f && gain >= m_target[out][in]) || (step < 0.0f && gain <= m_target[out][in]))
+      {
+        m_gain[out][in] = m_target[out][in];
+        m_step[out][in] = 0.0f;
+      }
+      else
+      {
+        m_gain[out][in] = gain;
+        m_ramping = true;
+      }
+    }
+  }
+}
+
+//the gain of a ramping cell at sample i of the block is gain + step * i,
+//clamped so that it doesn't go past the target
+void OPTIMIZE CMatrixMixer::MixOutput(int out, int offset, int samples)
+{
+  float* dst      = m_ports[MIX_OUT1 + out] + offset;
+  int    nractive = m_nractive[out];
+  int*   active   = m_active[out];
+
+  if (nractive == 0)
+  {
+    memset(dst, 0, samples * sizeof(float));
+    return;
+  }
+
+  int i = 0;
+
+#ifdef USE_SSE
+  //16 output samples are accumulated in registers, while the inputs are mixed in
+  for (; i + 15 < samples; i += 16)
+  {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    __m128 acc2 = _mm_setzero_ps();
+    __m128 acc3 = _mm_setzero_ps();
+
+    for (int c = 0; c < nractive; c++)
+    {
+      int          in   = active[c];
+      const float* src  = m_ports[MIX_IN1 + in] + offset + i;
+      float        gain = m_gain[out][in];
+      float        step = m_step[out][in];
+
+      if (step == 0.0f)
+      {
+        __m128 g = _mm_set1_ps(gain);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src), g));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src + 4), g));
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(src + 8), g));
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(src + 12), g));
+      }
+      else
+      {
+        float  target = m_target[out][in];
+        __m128 low    = _mm_set1_ps(Min(gain, target));
+        __m128 high   = _mm_set1_ps(Max(gain, target));
+        __m128 g      = _mm_add_ps(_mm_set1_ps(gain + step * i),
+                                   _mm_mul_ps(_mm_set1_ps(step), _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f)));
+        __m128 gstep  = _mm_set1_ps(step * 4.0f);
+
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(src), _mm_min_ps(_mm_max_ps(g, low), high)));
+        g = _mm_add_ps(g, gstep);
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(src + 4), _mm_min_ps(_mm_max_ps(g, low), high)));
+        g = _mm_add_ps(g, gstep);
+        acc2 = _mm_add_ps(acc2, _mm_mul_ps(_mm_loadu_ps(src + 8), _mm_min_ps(_mm_max_ps(g, low), high)));
+        g = _mm_add_ps(g, gstep);
+        acc3 = _mm_add_ps(acc3, _mm_mul_ps(_mm_loadu_ps(src + 12), _mm_min_ps(_mm_max_ps(g, low), high)));
+      }
+    }
+
+    _mm_storeu_ps(dst + i, acc0);
+    _mm_storeu_ps(dst + i + 4, acc1);
+    _mm_storeu_ps(dst + i + 8, acc2);
+    _mm_storeu_ps(dst + i + 12, acc3);
+  }
+#endif
+
+  for (; i < samples; i++)
+  {
+    float sum = 0.0f;
+    for (int c = 0; c < nractive; c++)
+    {
+      int   in   = active[c];
+      float gain = m_gain[out][in];
+      float step = m_step[out][in];
+      if (step != 0.0f)
+        gain = Clamp(gain + step * i, Min(gain, m_target[out][in]), Max(gain, m_target[out][in]));
+
+      sum += m_ports[MIX_IN1 + in][offset + i] * gain;
+    }
+    dst[i] = sum;
+  }
+}
+
+const LADSPA_PortDescriptor* CMatrixMixer::PortDescriptors()
+{
+  static LADSPA_PortDescriptor descriptors[MIX_NUMPORTS];
+
+  for (int channel = 0; channel < MIX_CHANNELS; channel++)
+  {
+    descriptors[MIX_IN1 + channel]  = LADSPA_PORT_INPUT  | LADSPA_PORT_AUDIO;
+    descriptors[MIX_OUT1 + channel] = LADSPA_PORT_OUTPUT | LADSPA_PORT_AUDIO;
+  }
+
+  for (int port = MIX_GAIN1; port < MIX_NUMPORTS; port++)
+    descriptors[port] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+
+  return descriptors;
+}
+
+const char* const* CMatrixMixer::PortNames()
+{
+  static char        strings[MIX_NUMPORTS][24];
+  static const char* names[MIX_NUMPORTS];
+
+  for (int channel = 0; channel < MIX_CHANNELS; channel++)
+  {
+    snprintf(strings[MIX_IN1 + channel], sizeof(strings[0]), "Input %i", channel + 1);
+    snprintf(strings[MIX_OUT1 + channel], sizeof(strings[0]), "Output %i", channel + 1);
+  }
+
+  for (int out = 0; out < MIX_CHANNELS; out++)
+  {
+    for (int in = 0; in < MIX_CHANNELS; in++)
+      snprintf(strings[MIX_GAINPORT(in, out)], sizeof(strings[0]), "In %i to out %i", in + 1, out + 1);
+  }
+
+  for (int port = 0; port < MIX_NUMPORTS; port++)
+    names[port] = strings[port];
+
+  return names;
+}
+
+const LADSPA_PortRangeHint* CMatrixMixer::PortRangeHints()
+{
+  static LADSPA_PortRangeHint hints[MIX_NUMPORTS];
+
+  memset(hints, 0, sizeof(hints));
+
+  //the default is every input to its own output
+  for (int out = 0; out < MIX_CHANNELS; out++)
+  {
+    for (int in = 0; in < MIX_CHANNELS; in++)
+    {
+      LADSPA_PortRangeHint& hint = hints[MIX_GAINPORT(in, out)];
+      hint.HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+                            (in == out ? LADSPA_HINT_DEFAULT_1 : LADSPA_HINT_DEFAULT_0);
+      hint.LowerBound     = -MIX_MAXGAIN;
+      hint.UpperBound     = MIX_MAXGAIN;
+    }
+  }
+
+  return hints;
+}
@@ -0,0 +1,86 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MATRIXMIXER_H
+#define MATRIXMIXER_H
+
+#include "util/ssedefs.h"
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+
+#define MIX_CHANNELS  16
+#define MIX_IN1       0
+#define MIX_OUT1      (MIX_IN1 + MIX_CHANNELS)
+#define MIX_GAIN1     (MIX_OUT1 + MIX_CHANNELS)
+#define MIX_NUMPORTS  (MIX_GAIN1 + MIX_CHANNELS * MIX_CHANNELS)
+
+//port of the gain from an input to an output
+#define MIX_GAINPORT(in, out) (MIX_GAIN1 + (out) * MIX_CHANNELS + (in))
+
+#define MIX_MAXGAIN   4.0f
+
+//gain changes are ramped linearly over this time
+#define MIX_RAMPTIME  0.05f
+
+//number of samples of every input that are mixed into all outputs before moving on,
+//16 inputs of 64 samples stay in the L1 cache while the outputs are made
+#define MIX_BLOCK     64
+
+namespace BobDSPLadspa
+{
+  //mixes up to 16 inputs into up to 16 outputs with a gain matrix, for every output only the
+  //inputs with a non-zero gain are mixed in, so the cost scales with the number of routes
+  class CMatrixMixer : public IFilter
+  {
+    public:
+      CMatrixMixer(unsigned long samplerate);
+      ~CMatrixMixer();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+      bool IsIdentity();
+
+      //the gain ports are generated, since there are so many of them
+      static const LADSPA_PortDescriptor* PortDescriptors();
+      static const char* const*           PortNames();
+      static const LADSPA_PortRangeHint*  PortRangeHints();
+
+    private:
+      void UpdateGains();
+      void MixOutput(int out, int offset, int samples);
+      void AdvanceRamps(int samples);
+
+      int          m_rampsamples;
+      bool         m_jump; //the first gains after Activate() are applied without a ramp
+      LADSPA_Data* m_ports[MIX_NUMPORTS];
+
+      //current gain, target gain and the change per sample, of every cell, by output and input
+      float        m_gain[MIX_CHANNELS][MIX_CHANNELS];
+      float        m_target[MIX_CHANNELS][MIX_CHANNELS];
+      float        m_step[MIX_CHANNELS][MIX_CHANNELS];
+
+      //inputs with a non-zero gain or a ramp, for every output
+      int          m_active[MIX_CHANNELS][MIX_CHANNELS];
+      int          m_nractive[MIX_CHANNELS];
+      bool         m_ramping;
+  };
+}
+
+#endif //MATRIXMIXER_H
@@ -22,6 +22,7 @@
 #include <math.h>
 #include <string.h>
 #include "acfilter.h"
+#include "util/ssedefs.h"
 
 
 #define ACW_F1  20.5990
@@ -34,7 +35,7 @@
 
 int ACfilter::init (int fsamp)
 {
-    double f, g;
+    double f, g, c, a;
 
     reset ();
     _w1 = _w2 = _w3 = _w4 = _ga = _gc = 0;     
@@ -47,8 +48,15 @@ int ACfilter::init (int fsamp)
     case 88200:	_w4 = 0.587; break;
     case 96000:	_w4 = 0.555; break;
     default:
-	_err = true;
-        return 1;
+	// Make the gain of the lowpass sections equal to the analog
+	// one at the corner frequency, or at 0.4 * fsamp when that is lower.
+	// For one section |w / (1 - (1 - w) / z)|^2 = a gives
+	// (1 - a) w^2 + 2a (1 - c) w - 2a (1 - c) = 0, with c = cos (wT).
+	f = (ACW_F4 < 0.4 * fsamp) ? ACW_F4 : 0.4 * fsamp;
+	c = cos (2 * M_PI * f / fsamp);
+	a = 1 / ((1 + f * f / (ACW_F4 * ACW_F4)) * sqrt (0.625 + 0.375 * c));
+	f = a * (1 - c);
+	_w4 = (sqrt (f * f + 2 * f * (1 - a)) - f) / (1 - a);
     }
 
     f = ACW_F1 / fsamp;
@@ -76,6 +84,7 @@ void ACfilter::reset (void)
 {
     // reset filter state
     _z1a = _z1b = _z2 = _z3 = _z4a = _z4b = 0;
+    memset (_zm, 0, sizeof (_zm));
 }
 
 
@@ -113,3 +122,105 @@ void ACfilter::process (size_t n, const float *in, float *opA, float *opC)
         if (opA) *opA++ = _ga * x;
     }
 }
+
+
+void ACfilter::process4 (size_t n, const float *in, float *opA, float *opC)
+{
+    if (_err)
+    {
+	if (opA) memset (opA, 0, 4 * n * sizeof (float));
+	if (opC) memset (opC, 0, 4 * n * sizeof (float));
+        return;
+    }
+
+#ifdef USE_SSE
+    __m128 x, y, e, w1, w2, w3, w4, ga, gc, c1, c3;
+    __m128 z1a, z1b, z2, z3, z4a, z4b;
+
+    e   = _mm_set1_ps (1e-20f);
+    w1  = _mm_set1_ps (_w1);
+    w2  = _mm_set1_ps (_w2);
+    w3  = _mm_set1_ps (_w3);
+    w4  = _mm_set1_ps (_w4);
+    ga  = _mm_set1_ps (_ga);
+    gc  = _mm_set1_ps (_gc);
+    c1  = _mm_set1_ps (0.25f);
+    c3  = _mm_set1_ps (0.75f);
+    z1a = _mm_loadu_ps (_zm [0]);
+    z1b = _mm_loadu_ps (_zm [1]);
+    z2  = _mm_loadu_ps (_zm [2]);
+    z3  = _mm_loadu_ps (_zm [3]);
+    z4a = _mm_loadu_ps (_zm [4]);
+    z4b = _mm_loadu_ps (_zm [5]);
+
+    while (n--)
+    {
+	x = _mm_loadu_ps (in);
+	// highpass sections, A and C
+	z1a = _mm_add_ps (z1a, _mm_mul_ps (w1, _mm_add_ps (_mm_sub_ps (x, z1a), e)));
+	x = _mm_sub_ps (x, z1a);
+	z1b = _mm_add_ps (z1b, _mm_mul_ps (w1, _mm_add_ps (_mm_sub_ps (x, z1b), e)));
+	x = _mm_sub_ps (x, z1b);
+	// lowpass sections, A, and C
+	z4a = _mm_add_ps (z4a, _mm_mul_ps (w4, _mm_sub_ps (x, z4a)));
+	y = _mm_mul_ps (c1, z4b);
+	z4b = _mm_add_ps (z4b, _mm_mul_ps (w4, _mm_sub_ps (z4a, z4b)));
+	x = _mm_add_ps (y, _mm_mul_ps (c3, z4b));
+	if (opC)
+	{
+	    _mm_storeu_ps (opC, _mm_mul_ps (gc, x));
+	    opC += 4;
+	}
+	// highpass sections, A only
+	if (opA)
+	{
+	    z2 = _mm_add_ps (z2, _mm_mul_ps (w2, _mm_add_ps (_mm_sub_ps (x, z2), e)));
+	    x = _mm_sub_ps (x, z2);
+	    z3 = _mm_add_ps (z3, _mm_mul_ps (w3, _mm_add_ps (_mm_sub_ps (x, z3), e)));
+	    x = _mm_sub_ps (x, z3);
+	    _mm_storeu_ps (opA, _mm_mul_ps (ga, x));
+	    opA += 4;
+	}
+	in += 4;
+    }
+
+    _mm_storeu_ps (_zm [0], z1a);
+    _mm_storeu_ps (_zm [1], z1b);
+    _mm_storeu_ps (_zm [2], z2);
+    _mm_storeu_ps (_zm [3], z3);
+    _mm_storeu_ps (_zm [4], z4a);
+    _mm_storeu_ps (_zm [5], z4b);
+#else
+    int   j;
+    float x, e;
+
+    e = 1e-20f;
+    while (n--)
+    {
+	for (j = 0; j < 4; j++)
+	{
+	    x = in [j];
+	    // highpass sections, A and C
+	    _zm [0][j] += _w1 * (x - _zm [0][j] + e);
+	    x -= _zm [0][j];
+	    _zm [1][j] += _w1 * (x - _zm [1][j] + e);
+	    x -= _zm [1][j];
+	    // lowpass sections, A, and C
+	    _zm [4][j] += _w4 * (x - _zm [4][j]);
+	    x  = 0.25f * _zm [5][j];
+	    _zm [5][j] += _w4 * (_zm [4][j] - _zm [5][j]);
+	    x += 0.75f * _zm [5][j];
+	    if (opC) opC [j] = _gc * x;
+	    // highpass sections, A only
+	    _zm [2][j] += _w2 * (x - _zm [2][j] + e);
+	    x -= _zm [2][j];
+	    _zm [3][j] += _w3 * (x - _zm [3][j] + e);
+	    x -= _zm [3][j];
+	    if (opA) opA [j] = _ga * x;
+	}
+	in += 4;
+	if (opA) opA += 4;
+	if (opC) opC += 4;
+    }
+#endif
+}
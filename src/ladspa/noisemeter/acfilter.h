@@ -36,12 +36,14 @@ public:
     int  init (int fsamp);
     void reset (void);
     void process (size_t n, const float *in, float *opA, float *opC);
+    void process4 (size_t n, const float *in, float *opA, float *opC);  // 4 interleaved channels
 
 private:
 
     bool  _err;
     float _w1, _w2, _w3, _w4, _ga, _gc;       // filter coefficients and gains
     float _z1a, _z1b, _z2, _z3, _z4a, _z4b;   // filter state
+    float _zm [6][4];                         // filter state of process4 (), one channel per lane
 };
 
 
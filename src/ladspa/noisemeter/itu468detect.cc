@@ -61,3 +61,27 @@ void Itu468detect::process (int n, const float *inp)
     _z1 = z1;
     _z2 = z2;
 }
+
+
+// Same as above, and writes value() for every sample to out.
+
+void Itu468detect::process (int n, const float *inp, float *out)
+{
+    float x, z1, z2;
+
+    z1 = _z1;
+    z2 = _z2;
+
+    while (n--)
+    {
+	x = fabsf (*inp++) + 1e-30f;
+	z1 -= z1 * _b1;
+	if (x > z1) z1 += _a1 * (x - z1);
+	z2 -= z2 * _b2;
+	if (z1 > z2) z2 += _a2 * (z1 - z2);
+	*out++ = 1.1453f * z2;
+    }
+
+    _z1 = z1;
+    _z2 = z2;
+}
@@ -33,6 +33,7 @@ public:
     int   init (int fsamp);
     void  reset (void);
     void  process (int n, const float *inp);
+    void  process (int n, const float *inp, float *out);
     float value (void) { return 1.1453f * _z2; }
 
 private:
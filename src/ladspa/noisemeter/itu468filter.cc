@@ -19,12 +19,45 @@
 // ----------------------------------------------------------------------- 
 
 
+#include <math.h>
 #include <string.h>
 #include "itu468filter.h"
+#include "util/ssedefs.h"
 
 
 #define GREF2K 0.5239f
 
+// Poles of the analog ITU-R 468 network, in Hz.
+#define P1R  -4122.702066
+#define P2R  -9975.063124
+#define P3R  -3758.529163
+#define P3I   5790.042337
+#define P4R  -2983.159938
+#define P4I   9940.842646
+
+
+// Gain of the analog network, 1 at 6.3 kHz.
+static double gain468 (double f)
+{
+    double f2, h1, h2;
+
+    f2 = f * f;
+    h1 = ((-4.737338981378384e-24 * f2 + 2.043828333606125e-15) * f2 - 1.363894795463638e-7) * f2 + 1;
+    h2 = ((1.306612257412824e-19 * f2 - 2.118150887518656e-11) * f2 + 5.559488023498642e-4) * f;
+    return 1.246332637532143e-4 * f / sqrt (h1 * h1 + h2 * h2);
+}
+
+
+// Modulus of 1 + b1 / z + b2 / z^2 for z = exp (jw).
+static double modulus (double b1, double b2, double w)
+{
+    double re, im;
+
+    re = 1 + b1 * cos (w) + b2 * cos (2 * w);
+    im = b1 * sin (w) + b2 * sin (2 * w);
+    return sqrt (re * re + im * im);
+}
+
 
 int Itu468filter::init (int fsamp, bool ref2k)
 {
@@ -86,8 +119,7 @@ int Itu468filter::init (int fsamp, bool ref2k)
   	break;
 
     default:
-	_err = true;
-        return 1;
+	design (fsamp);
     }
 
     if (ref2k)
@@ -101,12 +133,59 @@ int Itu468filter::init (int fsamp, bool ref2k)
 }
 
 
+void Itu468filter::design (int fsamp)
+{
+    int    i;
+    double r, w, fm, c, d, q, g [2];
+
+    // The poles of the analog network are mapped by z = exp (sT),
+    // the two real ones go to the highpass and the first section.
+    r = exp (2 * M_PI * P1R / fsamp);
+    _whp = 1 - r;
+    r = exp (2 * M_PI * P2R / fsamp);
+    _a11 = -r;
+    _a12 = 0;
+    r = exp (2 * M_PI * P3R / fsamp);
+    _a21 = -2 * r * cos (2 * M_PI * P3I / fsamp);
+    _a22 = r * r;
+    r = exp (2 * M_PI * P4R / fsamp);
+    _a31 = -2 * r * cos (2 * M_PI * P4I / fsamp);
+    _a32 = r * r;
+
+    // Gain of the highpass and the poles at 1 kHz and at fm.
+    fm = (0.4 * fsamp < 20e3) ? 0.4 * fsamp : 20e3;
+    for (i = 0; i < 2; i++)
+    {
+	w = 2 * M_PI * (i ? fm : 1e3) / fsamp;
+	g [i] = (1 - _whp) * modulus (-1, 0, w)
+	      / (modulus (_whp - 1, 0, w) * modulus (_a11, _a12, w) * modulus (_a21, _a22, w) * modulus (_a31, _a32, w));
+    }
+
+    // The five zeros at infinity are replaced by a double zero at -q,
+    // which makes the gain at fm relative to 1 kHz equal to the analog one.
+    // This needs (1 + 2q cos (wm) + q^2) / (1 + 2q cos (w1) + q^2) = r,
+    // of the two solutions with q * q = 1 the one inside the unit circle is used.
+    r = (gain468 (fm) / gain468 (1e3)) / (g [1] / g [0]);
+    c = 1 - r;
+    d = cos (2 * M_PI * fm / fsamp) - r * cos (2 * M_PI * 1e3 / fsamp);
+    d = (d * d > c * c) ? sqrt (d * d - c * c) - d : -d;
+    q = (fabs (d) < fabs (c)) ? d / c : c / d;
+
+    // Unity gain at 1 kHz.
+    w = 2 * M_PI * 1e3 / fsamp;
+    _b30 = 1 / (g [0] * (1 + 2 * q * cos (w) + q * q));
+    _b31 = 2 * q * _b30;
+    _b32 = q * q * _b30;
+}
+
+
 void Itu468filter::reset (void)
 {
     _zhp = 0;
     _z11 = _z12 = 0;
     _z21 = _z22 = 0;
     _z31 = _z32 = 0;
+    memset (_zm, 0, sizeof (_zm));
 }
 
 
@@ -153,3 +232,89 @@ void Itu468filter::process (size_t n, const float *inp, float *out)
     _z31 = z31;
     _z32 = z32;
 }
+
+
+void Itu468filter::process4 (size_t n, const float *inp, float *out)
+{
+    if (_err)
+    {
+	memset (out, 0, 4 * n * sizeof (float));
+        return;
+    }
+
+#ifdef USE_SSE
+    __m128 x, e, whp, a11, a12, a21, a22, a31, a32, b30, b31, b32;
+    __m128 zhp, z11, z12, z21, z22, z31, z32;
+
+    e   = _mm_set1_ps (1e-20f);
+    whp = _mm_set1_ps (_whp);
+    a11 = _mm_set1_ps (_a11);
+    a12 = _mm_set1_ps (_a12);
+    a21 = _mm_set1_ps (_a21);
+    a22 = _mm_set1_ps (_a22);
+    a31 = _mm_set1_ps (_a31);
+    a32 = _mm_set1_ps (_a32);
+    b30 = _mm_set1_ps (_b30);
+    b31 = _mm_set1_ps (_b31);
+    b32 = _mm_set1_ps (_b32);
+    zhp = _mm_loadu_ps (_zm [0]);
+    z11 = _mm_loadu_ps (_zm [1]);
+    z12 = _mm_loadu_ps (_zm [2]);
+    z21 = _mm_loadu_ps (_zm [3]);
+    z22 = _mm_loadu_ps (_zm [4]);
+    z31 = _mm_loadu_ps (_zm [5]);
+    z32 = _mm_loadu_ps (_zm [6]);
+
+    while (n--)
+    {
+	x = _mm_loadu_ps (inp);
+	zhp = _mm_add_ps (zhp, _mm_add_ps (_mm_mul_ps (whp, _mm_sub_ps (x, zhp)), e));
+	x = _mm_sub_ps (x, zhp);
+	x = _mm_sub_ps (x, _mm_add_ps (_mm_mul_ps (a11, z11), _mm_mul_ps (a12, z12)));
+	z12 = z11;
+	z11 = x;
+	x = _mm_sub_ps (x, _mm_add_ps (_mm_mul_ps (a21, z21), _mm_mul_ps (a22, z22)));
+	z22 = z21;
+	z21 = x;
+	x = _mm_sub_ps (x, _mm_add_ps (_mm_mul_ps (a31, z31), _mm_mul_ps (a32, z32)));
+	_mm_storeu_ps (out, _mm_add_ps (_mm_add_ps (_mm_mul_ps (b30, x), _mm_mul_ps (b31, z31)), _mm_mul_ps (b32, z32)));
+	z32 = z31;
+	z31 = x;
+	inp += 4;
+	out += 4;
+    }
+
+    _mm_storeu_ps (_zm [0], zhp);
+    _mm_storeu_ps (_zm [1], z11);
+    _mm_storeu_ps (_zm [2], z12);
+    _mm_storeu_ps (_zm [3], z21);
+    _mm_storeu_ps (_zm [4], z22);
+    _mm_storeu_ps (_zm [5], z31);
+    _mm_storeu_ps (_zm [6], z32);
+#else
+    int   j;
+    float x;
+
+    while (n--)
+    {
+	for (j = 0; j < 4; j++)
+	{
+	    x = inp [j];
+	    _zm [0][j] += _whp * (x - _zm [0][j]) + 1e-20f;
+	    x -= _zm [0][j];
+	    x -= _a11 * _zm [1][j] + _a12 * _zm [2][j];
+	    _zm [2][j] = _zm [1][j];
+	    _zm [1][j] = x;
+	    x -= _a21 * _zm [3][j] + _a22 * _zm [4][j];
+	    _zm [4][j] = _zm [3][j];
+	    _zm [3][j] = x;
+	    x -= _a31 * _zm [5][j] + _a32 * _zm [6][j];
+	    out [j] = _b30 * x + _b31 * _zm [5][j] + _b32 * _zm [6][j];
+	    _zm [6][j] = _zm [5][j];
+	    _zm [5][j] = x;
+	}
+	inp += 4;
+	out += 4;
+    }
+#endif
+}
@@ -36,9 +36,12 @@ public:
     int  init (int fsamp, bool ref2k = false);
     void reset (void);
     void process (size_t n, const float *inp, float *out);
+    void process4 (size_t n, const float *inp, float *out);  // 4 interleaved channels
 
 private:
 
+    void design (int fsamp);
+
     bool     _err;
     float    _whp;
     float    _a11, _a12;
@@ -49,6 +52,7 @@ private:
     float    _z11, _z12;
     float    _z21, _z22;
     float    _z31, _z32;
+    float    _zm [7][4];     // filter state of process4 (), one channel per lane
 };
 
 #endif
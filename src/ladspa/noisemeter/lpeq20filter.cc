@@ -20,8 +20,21 @@
 
 
 #include "lpeq20filter.h"
+#include "util/ssedefs.h"
 
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
+
+
+// Analog prototype, two pole pairs with these relative
+// damping factors, the second one at F2 and the first
+// one at R1 * F2. For sample rates without coefficients
+// in the table F2 is prewarped to LPEQ_F2.
+#define LPEQ_D1  0.808014
+#define LPEQ_D2  0.229050
+#define LPEQ_R1  0.684363
+#define LPEQ_F2  18732.5
 
 
 //float calcpar (float f)
@@ -34,6 +47,9 @@
 
 int LPeq20filter::init (int fsamp)
 {
+    int    i;
+    double f, k, w, d, a0, a1, a2, b [5];
+
     reset ();
     switch (fsamp)
     {
@@ -66,7 +82,33 @@ int LPeq20filter::init (int fsamp)
 	_b4 =  1.45713514e-01f;
         break;
     default:
-        return 1;
+	// Bilinear transform of the prototype, both sections have
+	// w^2 (1 + 1/z)^2 / (a0 + a1 / z + a2 / z^2) with k = 2 * fsamp.
+	// Below 44.1 kHz the corner is kept below the Nyquist frequency.
+	f = (LPEQ_F2 < 0.42 * fsamp) ? LPEQ_F2 : 0.42 * fsamp;
+	k = 2.0 * fsamp;
+	w = k * tan (M_PI * f / fsamp) * LPEQ_R1;
+	d = LPEQ_D1;
+	b [0] = 1;
+	b [1] = b [2] = b [3] = b [4] = 0;
+	_g = 1;
+	for (i = 0; i < 2; i++)
+	{
+	    a0 = k * k + 2 * d * w * k + w * w;
+	    a1 = (2 * w * w - 2 * k * k) / a0;
+	    a2 = (k * k - 2 * d * w * k + w * w) / a0;
+	    _g *= w * w / a0;
+	    b [4] = b [2] * a2;
+	    b [3] = b [2] * a1 + b [1] * a2;
+	    b [2] = b [2] + b [1] * a1 + a2;
+	    b [1] = b [1] + a1;
+	    w /= LPEQ_R1;
+	    d = LPEQ_D2;
+	}
+	_b1 = b [1];
+	_b2 = b [2];
+	_b3 = b [3];
+	_b4 = b [4];
     }
     return 0;
 }
@@ -75,6 +117,7 @@ int LPeq20filter::init (int fsamp)
 void LPeq20filter::reset (void)
 {
     _z1 = _z2 = _z3 = _z4 = 0;
+    memset (_zm, 0, sizeof (_zm));
 }
 
 
@@ -102,3 +145,64 @@ void LPeq20filter::process (size_t n, const float *inp, float *out)
     _z4 = z4;
 }
 
+
+void LPeq20filter::process4 (size_t n, const float *inp, float *out)
+{
+#ifdef USE_SSE
+    __m128 x, y, e, g, b1, b2, b3, b4, c4, c6, z1, z2, z3, z4;
+
+    e  = _mm_set1_ps (1e-20f);
+    g  = _mm_set1_ps (_g);
+    b1 = _mm_set1_ps (_b1);
+    b2 = _mm_set1_ps (_b2);
+    b3 = _mm_set1_ps (_b3);
+    b4 = _mm_set1_ps (_b4);
+    c4 = _mm_set1_ps (4.0f);
+    c6 = _mm_set1_ps (6.0f);
+    z1 = _mm_loadu_ps (_zm [0]);
+    z2 = _mm_loadu_ps (_zm [1]);
+    z3 = _mm_loadu_ps (_zm [2]);
+    z4 = _mm_loadu_ps (_zm [3]);
+
+    while (n--)
+    {
+	x = _mm_add_ps (_mm_loadu_ps (inp), e);
+	y = _mm_add_ps (_mm_mul_ps (b1, z1), _mm_mul_ps (b2, z2));
+	y = _mm_add_ps (_mm_add_ps (y, _mm_mul_ps (b3, z3)), _mm_mul_ps (b4, z4));
+	x = _mm_sub_ps (x, y);
+	y = _mm_add_ps (_mm_add_ps (x, z4), _mm_mul_ps (c4, _mm_add_ps (z1, z3)));
+	y = _mm_add_ps (y, _mm_mul_ps (c6, z2));
+	_mm_storeu_ps (out, _mm_mul_ps (g, y));
+	z4 = z3;
+	z3 = z2;
+	z2 = z1;
+	z1 = x;
+	inp += 4;
+	out += 4;
+    }
+
+    _mm_storeu_ps (_zm [0], z1);
+    _mm_storeu_ps (_zm [1], z2);
+    _mm_storeu_ps (_zm [2], z3);
+    _mm_storeu_ps (_zm [3], z4);
+#else
+    int   j;
+    float x;
+
+    while (n--)
+    {
+	for (j = 0; j < 4; j++)
+	{
+	    x = inp [j] + 1e-20f;
+	    x -= _b1 * _zm [0][j] + _b2 * _zm [1][j] + _b3 * _zm [2][j] + _b4 * _zm [3][j];
+	    out [j] = _g * (x + _zm [3][j] + 4 * (_zm [0][j] + _zm [2][j]) + 6 * _zm [1][j]);
+	    _zm [3][j] = _zm [2][j];
+	    _zm [2][j] = _zm [1][j];
+	    _zm [1][j] = _zm [0][j];
+	    _zm [0][j] = x;
+	}
+	inp += 4;
+	out += 4;
+    }
+#endif
+}
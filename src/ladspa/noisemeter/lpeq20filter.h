@@ -36,12 +36,14 @@ public:
     int  init (int fsamp);
     void reset (void);
     void process (size_t n, const float *inp, float *out);
+    void process4 (size_t n, const float *inp, float *out);  // 4 interleaved channels
 
 private:
 
     float _g;
     float _b1, _b2, _b3, _b4;	       
     float _z1, _z2, _z3, _z4;
+    float _zm [4][4];	       // filter state of process4 (), one channel per lane
 };
 
 #endif
@@ -52,3 +52,21 @@ void RMSdetect::process (int n, const float *inp)
     _z = z;
 }
 
+
+// Same as above, and writes value() for every sample to out.
+
+void RMSdetect::process (int n, const float *inp, float *out)
+{
+    float w, x, z;
+
+    w = _slow ? (_w / 8) : _w;
+    z = _z + 1e-30f;
+    while (n--)
+    {
+	x = *inp++;
+	z += w * (x * x - z);
+	*out++ = sqrtf (2 * z);
+    }
+    _z = z;
+}
+
@@ -37,6 +37,7 @@ public:
     void  reset (void);
     void  speed (bool slow) { _slow = slow; }
     void  process (int n, const float *inp);
+    void  process (int n, const float *inp, float *out);
     float value (void) { return sqrtf (2 * _z); }
 
 private:
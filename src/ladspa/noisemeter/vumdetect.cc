@@ -38,6 +38,9 @@ void VUMdetect::reset (void)
 }
 
 
+// z2 is clipped at 0 for every sample, so that processing a block
+// gives the same result as calling process() one sample at a time.
+
 void VUMdetect::process (int n, const float *inp)
 {
     float w, x, z1, z2;
@@ -50,8 +53,30 @@ void VUMdetect::process (int n, const float *inp)
 	x = fabsf (*inp++) - 0.55f * z2;
 	z1 += w * (x - z1);
 	z2 += w * (z1 - z2);
+	if (z2 < 0) z2 = 0;
+    }
+    _z1 = z1 - 1e-30f;
+    _z2 = z2;
+}
+
+
+// Same as above, and writes value() for every sample to out.
+
+void VUMdetect::process (int n, const float *inp, float *out)
+{
+    float w, x, z1, z2;
+
+    w = _slow ? (0.1f * _w) : _w;
+    z1 = _z1 + 1e-30f;
+    z2 = _z2;
+    while (n--)
+    {
+	x = fabsf (*inp++) - 0.55f * z2;
+	z1 += w * (x - z1);
+	z2 += w * (z1 - z2);
+	if (z2 < 0) z2 = 0;
+	*out++ = 2.435f * z2;
     }
-    if (z2 < 0) z2 = 0;
     _z1 = z1 - 1e-30f;
     _z2 = z2;
 }
@@ -34,6 +34,7 @@ public:
     void  reset (void);
     void  speed (bool slow) { _slow = slow; }
     void  process (int n, const float *inp);
+    void  process (int n, const float *inp, float *out);
     float value (void) { return 2.435f * _z2; }
     
 
@@ -30,12 +30,13 @@ enum EDETECTTYPE
   AVG    = 2
 };
 
-CNoiseMeterDetect::CNoiseMeterDetect(unsigned long samplerate)
+CNoiseMeterDetect::CNoiseMeterDetect(unsigned long samplerate, bool controloutput)
 {
   memset(m_ports, 0, sizeof(m_ports));
   m_samplerate = samplerate;
   m_type = NONE;
   m_slow = -1;
+  m_controloutput = controloutput;
 }
 
 CNoiseMeterDetect::~CNoiseMeterDetect()
@@ -56,32 +57,39 @@ void CNoiseMeterDetect::Run(unsigned long samplecount)
   InitFilter();
 
   LADSPA_Data* in = m_ports[0];
-  LADSPA_Data* inend = in + samplecount;
   LADSPA_Data* out = m_ports[1];
 
-  if (m_type == ITU468)
+  //the detectors run over the whole block with their state in registers
+  if (m_controloutput)
   {
-    while (in != inend)
+    if (m_type == ITU468)
     {
-      m_itu468detect.process(1, in++);
-      *(out++) = m_itu468detect.value();
+      m_itu468detect.process(samplecount, in);
+      *out = m_itu468detect.value();
     }
-  }
-  else if (m_type == RMS)
-  {
-    while (in != inend)
+    else if (m_type == RMS)
     {
-      m_rmsdetect.process(1, in++);
-      *(out++) = m_rmsdetect.value();
+      m_rmsdetect.process(samplecount, in);
+      *out = m_rmsdetect.value();
     }
-  }
-  else if (m_type == AVG)
-  {
-    while (in != inend)
+    else if (m_type == AVG)
     {
-      m_vumdetect.process(1, in++);
-      *(out++) = m_vumdetect.value();
+      m_vumdetect.process(samplecount, in);
+      *out = m_vumdetect.value();
     }
+    else
+    {
+      *out = 0.0f;
+    }
+  }
+  else
+  {
+    if (m_type == ITU468)
+      m_itu468detect.process(samplecount, in, out);
+    else if (m_type == RMS)
+      m_rmsdetect.process(samplecount, in, out);
+    else if (m_type == AVG)
+      m_vumdetect.process(samplecount, in, out);
   }
 }
 
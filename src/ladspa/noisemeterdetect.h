@@ -31,7 +31,9 @@ namespace BobDSPLadspa
   class CNoiseMeterDetect : public IFilter
   {
     public:
-      CNoiseMeterDetect(unsigned long samplerate);
+      //when controloutput is true, the output port is a control port,
+      //which gets the value of the detector at the end of every Run()
+      CNoiseMeterDetect(unsigned long samplerate, bool controloutput);
       ~CNoiseMeterDetect();
 
       void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
@@ -46,6 +48,7 @@ namespace BobDSPLadspa
       int32_t       m_type;
       unsigned long m_samplerate;
       int32_t       m_slow;
+      bool          m_controloutput;
 
       Itu468detect  m_itu468detect;
       RMSdetect     m_rmsdetect;
@@ -33,9 +33,10 @@ enum EWEIGHTINGTYPE
   ITU_R468_DOLBY,
 };
 
-CNoiseMeterWeighting::CNoiseMeterWeighting(unsigned long samplerate)
+CNoiseMeterWeighting::CNoiseMeterWeighting(unsigned long samplerate, int channels)
 {
   memset(m_ports, 0, sizeof(m_ports));
+  m_channels = channels;
   m_samplerate = samplerate;
   m_type = NONE;
 }
@@ -57,7 +58,9 @@ void CNoiseMeterWeighting::Run(unsigned long samplecount)
 {
   InitFilter();
 
-  if (m_type == FLAT)
+  if (m_channels > 1)
+    RunMultiChannel(samplecount);
+  else if (m_type == FLAT)
     memcpy(m_ports[1], m_ports[0], samplecount * sizeof(LADSPA_Data));
   else if (m_type == LOWPASS)
     m_lpeq20filter.process(samplecount, m_ports[0], m_ports[1]);
@@ -69,13 +72,85 @@ void CNoiseMeterWeighting::Run(unsigned long samplecount)
     m_itu468filter.process(samplecount, m_ports[0], m_ports[1]);
 }
 
+void OPTIMIZE CNoiseMeterWeighting::RunMultiChannel(unsigned long samplecount)
+{
+  LADSPA_Data** in  = m_ports;
+  LADSPA_Data** out = m_ports + NMW_MAXCHANNELS;
+
+  if (m_type == FLAT)
+  {
+    for (int channel = 0; channel < NMW_MAXCHANNELS; channel++)
+      memcpy(out[channel], in[channel], samplecount * sizeof(LADSPA_Data));
+    return;
+  }
+
+  //the filters take the channels interleaved, so that each sample is one vector
+  for (unsigned long i = 0; i < samplecount; i += NMW_CHUNK)
+  {
+    int samples = Min((int)(samplecount - i), NMW_CHUNK);
+
+    int j = 0;
+#ifdef USE_SSE
+    for (; j + 4 <= samples; j += 4)
+    {
+      __m128 r0 = _mm_loadu_ps(in[0] + i + j);
+      __m128 r1 = _mm_loadu_ps(in[1] + i + j);
+      __m128 r2 = _mm_loadu_ps(in[2] + i + j);
+      __m128 r3 = _mm_loadu_ps(in[3] + i + j);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _mm_storeu_ps(m_inbuf + j * NMW_MAXCHANNELS,      r0);
+      _mm_storeu_ps(m_inbuf + j * NMW_MAXCHANNELS + 4,  r1);
+      _mm_storeu_ps(m_inbuf + j * NMW_MAXCHANNELS + 8,  r2);
+      _mm_storeu_ps(m_inbuf + j * NMW_MAXCHANNELS + 12, r3);
+    }
+#endif
+    for (; j < samples; j++)
+      for (int channel = 0; channel < NMW_MAXCHANNELS; channel++)
+        m_inbuf[j * NMW_MAXCHANNELS + channel] = in[channel][i + j];
+
+    if (m_type == LOWPASS)
+      m_lpeq20filter.process4(samples, m_inbuf, m_outbuf);
+    else if (m_type == A_WEIGHTING)
+      m_acfilter.process4(samples, m_inbuf, m_outbuf, NULL);
+    else if (m_type == C_WEIGHTING)
+      m_acfilter.process4(samples, m_inbuf, NULL, m_outbuf);
+    else if (m_type == ITU_R468 || m_type == ITU_R468_DOLBY)
+      m_itu468filter.process4(samples, m_inbuf, m_outbuf);
+
+    j = 0;
+#ifdef USE_SSE
+    for (; j + 4 <= samples; j += 4)
+    {
+      __m128 r0 = _mm_loadu_ps(m_outbuf + j * NMW_MAXCHANNELS);
+      __m128 r1 = _mm_loadu_ps(m_outbuf + j * NMW_MAXCHANNELS + 4);
+      __m128 r2 = _mm_loadu_ps(m_outbuf + j * NMW_MAXCHANNELS + 8);
+      __m128 r3 = _mm_loadu_ps(m_outbuf + j * NMW_MAXCHANNELS + 12);
+      _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+      _mm_storeu_ps(out[0] + i + j, r0);
+      _mm_storeu_ps(out[1] + i + j, r1);
+      _mm_storeu_ps(out[2] + i + j, r2);
+      _mm_storeu_ps(out[3] + i + j, r3);
+    }
+#endif
+    for (; j < samples; j++)
+      for (int channel = 0; channel < NMW_MAXCHANNELS; channel++)
+        out[channel][i + j] = m_outbuf[j * NMW_MAXCHANNELS + channel];
+  }
+}
+
 void CNoiseMeterWeighting::Deactivate()
 {
 }
 
+bool CNoiseMeterWeighting::IsIdentity()
+{
+  InitFilter();
+  return m_type == FLAT;
+}
+
 void CNoiseMeterWeighting::InitFilter()
 {
-  int32_t type = Clamp((int32_t)FLAT, Round32(*(m_ports[2])), (int32_t)ITU_R468_DOLBY);
+  int32_t type = Clamp((int32_t)FLAT, Round32(*(m_ports[m_channels * 2])), (int32_t)ITU_R468_DOLBY);
 
   if (type != m_type)
   {
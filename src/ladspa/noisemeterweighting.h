@@ -20,35 +20,46 @@
 #define NOISEMETERWEIGHTING_H
 
 #include "util/inclstdint.h"
+#include "util/ssedefs.h"
 #include "filterdescriptions.h"
 #include "filterinterface.h"
 #include "noisemeter/acfilter.h"
 #include "noisemeter/itu468filter.h"
 #include "noisemeter/lpeq20filter.h"
 
+//the multichannel variant runs its channels in the lanes of one sse vector
+#define NMW_MAXCHANNELS 4
+#define NMW_CHUNK       256
+
 namespace BobDSPLadspa
 {
   class CNoiseMeterWeighting : public IFilter
   {
     public:
-      CNoiseMeterWeighting(unsigned long samplerate);
+      CNoiseMeterWeighting(unsigned long samplerate, int channels);
       ~CNoiseMeterWeighting();
 
       void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
       void Activate();
       void Run(unsigned long samplecount);
       void Deactivate();
+      bool IsIdentity();
 
     private:
       void          InitFilter();
+      void          RunMultiChannel(unsigned long samplecount);
 
-      LADSPA_Data*  m_ports[3];
+      LADSPA_Data*  m_ports[NMW_MAXCHANNELS * 2 + 1];
+      int           m_channels;
       int32_t       m_type;
       unsigned long m_samplerate;
 
       ACfilter      m_acfilter;
       Itu468filter  m_itu468filter;
       LPeq20filter  m_lpeq20filter;
+
+      float         m_inbuf[NMW_CHUNK * NMW_MAXCHANNELS];
+      float         m_outbuf[NMW_CHUNK * NMW_MAXCHANNELS];
   };
 }
 
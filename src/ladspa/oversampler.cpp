@@ -0,0 +1,273 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "oversampler.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+//K of every stage for every quality, the first stage needs the steepest filter, since the later
+//stages only have to remove images above the original nyquist frequency
+static const int g_stagek[OS_NUMQUALITIES][OS_MAXSTAGES] =
+{
+  {  4, 2, 2 },
+  {  8, 4, 3 },
+  { 16, 6, 4 }
+};
+
+//kaiser window beta of every quality
+static const double g_kaiserbeta[OS_NUMQUALITIES] = { 5.0, 7.0, 9.0 };
+
+//modified bessel function of the first kind, order 0
+static double BesselI0(double x)
+{
+  double sum  = 1.0;
+  double term = 1.0;
+  for (int i = 1; i < 50; i++)
+  {
+    term *= (x / (2.0 * i)) * (x / (2.0 * i));
+    sum  += term;
+    if (term < sum * 1e-12)
+      break;
+  }
+
+  return sum;
+}
+
+//y[i] = sum of coefs[j] * (x[i - j] + x[i - (2 * k - 1) + j]) for j from 0 to k - 1,
+//x has 2 * k - 1 samples of history before x[0]
+static void OPTIMIZE SymmetricFir(const float* x, float* y, int samples, const float* coefs, int k)
+{
+  int i = 0;
+#ifdef USE_SSE
+  for (; i + 3 < samples; i += 4)
+  {
+    __m128 sum0 = _mm_setzero_ps();
+    __m128 sum1 = _mm_setzero_ps();
+    int    j    = 0;
+    for (; j + 1 < k; j += 2)
+    {
+      sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_set1_ps(coefs[j]),
+                        _mm_add_ps(_mm_loadu_ps(x + i - j), _mm_loadu_ps(x + i - (2 * k - 1) + j))));
+      sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_set1_ps(coefs[j + 1]),
+                        _mm_add_ps(_mm_loadu_ps(x + i - j - 1), _mm_loadu_ps(x + i - (2 * k - 1) + j + 1))));
+    }
+
+    if (j < k)
+      sum0 = _mm_add_ps(sum0, _mm_mul_ps(_mm_set1_ps(coefs[j]),
+                        _mm_add_ps(_mm_loadu_ps(x + i - j), _mm_loadu_ps(x + i - (2 * k - 1) + j))));
+
+    _mm_storeu_ps(y + i, _mm_add_ps(sum0, sum1));
+  }
+#endif
+
+  for (; i < samples; i++)
+  {
+    float sum = 0.0f;
+    for (int j = 0; j < k; j++)
+      sum += coefs[j] * (x[i - j] + x[i - (2 * k - 1) + j]);
+
+    y[i] = sum;
+  }
+}
+
+CHalfBandStage::CHalfBandStage()
+{
+  m_k = 0;
+  SetLength(g_stagek[OS_MEDIUM][0], g_kaiserbeta[OS_MEDIUM]);
+}
+
+CHalfBandStage::~CHalfBandStage()
+{
+}
+
+//the half-band filter h has 4 * k - 1 taps, centered on tap 2 * k - 1,
+//the taps at an even distance from the center are zero, except the center which is 0.5,
+//m_coefs holds the taps at an odd distance from the center, multiplied by 2
+void CHalfBandStage::SetLength(int k, double beta)
+{
+  k = Clamp(k, 1, OS_MAXK);
+
+  double center = 2 * k - 1;
+  for (int j = 0; j < k; j++)
+  {
+    double t      = (2 * j - center) / 2.0;
+    double ratio  = (2 * j - center) / (center + 1.0);
+    double window = BesselI0(beta * sqrt(1.0 - ratio * ratio)) / BesselI0(beta);
+    m_coefs[j] = sin(M_PI * t) / (M_PI * t) * window;
+  }
+
+  //normalize the gain at 0 hertz to 1, the sum of the coefficients of both phases is 2
+  double sum = 0.0;
+  for (int j = 0; j < k; j++)
+    sum += 2.0 * m_coefs[j];
+
+  for (int j = 0; j < k; j++)
+    m_coefs[j] /= sum;
+
+  if (k != m_k)
+  {
+    m_k = k;
+    Reset();
+  }
+}
+
+void CHalfBandStage::Reset()
+{
+  memset(m_uphist, 0, sizeof(m_uphist));
+  memset(m_downeven, 0, sizeof(m_downeven));
+  memset(m_downodd, 0, sizeof(m_downodd));
+}
+
+void OPTIMIZE CHalfBandStage::Up(const float* in, float* out, int samples)
+{
+  int    hist = 2 * m_k - 1;
+  float* x    = m_uphist + hist;
+  memcpy(x, in, samples * sizeof(float));
+
+  //the even output samples are the FIR phase, the odd output samples are the input delayed by k - 1 samples
+  float fir[OS_MAXBLOCK * OS_MAXFACTOR / 2];
+  SymmetricFir(x, fir, samples, m_coefs, m_k);
+
+  const float* delayed = x - (m_k - 1);
+  for (int i = 0; i < samples; i++)
+  {
+    out[i * 2]     = fir[i];
+    out[i * 2 + 1] = delayed[i];
+  }
+
+  memmove(m_uphist, m_uphist + samples, hist * sizeof(float));
+}
+
+void OPTIMIZE CHalfBandStage::Down(const float* in, float* out, int samples)
+{
+  int    hist = 2 * m_k - 1;
+  float* even = m_downeven + hist;
+  float* odd  = m_downodd + hist;
+  for (int i = 0; i < samples; i++)
+  {
+    even[i] = in[i * 2];
+    odd[i]  = in[i * 2 + 1];
+  }
+
+  //the FIR phase runs on the even input samples, the center tap on the odd input samples
+  SymmetricFir(even, out, samples, m_coefs, m_k);
+
+  const float* delayed = odd - m_k;
+  for (int i = 0; i < samples; i++)
+    out[i] = (out[i] + delayed[i]) * 0.5f;
+
+  memmove(m_downeven, m_downeven + samples, hist * sizeof(float));
+  memmove(m_downodd, m_downodd + samples, hist * sizeof(float));
+}
+
+COversampler::COversampler()
+{
+  m_stages  = 0;
+  m_quality = OS_MEDIUM;
+}
+
+COversampler::~COversampler()
+{
+}
+
+void COversampler::SetFactor(int factor, EOSQUALITY quality)
+{
+  int stages = 0;
+  while (stages < OS_MAXSTAGES && (1 << stages) < factor)
+    stages++;
+
+  if (stages == m_stages && quality == m_quality)
+    return;
+
+  m_stages  = stages;
+  m_quality = quality;
+
+  for (int s = 0; s < OS_MAXSTAGES; s++)
+    m_stage[s].SetLength(g_stagek[quality][s], g_kaiserbeta[quality]);
+
+  Reset();
+}
+
+void COversampler::Reset()
+{
+  for (int s = 0; s < OS_MAXSTAGES; s++)
+    m_stage[s].Reset();
+}
+
+float COversampler::Latency()
+{
+  //stage s runs at 2 << s times the base rate
+  float latency = 0.0f;
+  for (int s = 0; s < m_stages; s++)
+    latency += (float)m_stage[s].Delay() / (float)(2 << s);
+
+  return latency;
+}
+
+void COversampler::Upsample(const float* in, float* out, int samples)
+{
+  if (m_stages == 0)
+  {
+    if (in != out)
+      memcpy(out, in, samples * sizeof(float));
+    return;
+  }
+
+  int factor = Factor();
+  for (int i = 0; i < samples; i += OS_MAXBLOCK)
+  {
+    int block = Min(samples - i, OS_MAXBLOCK);
+
+    //every stage doubles the number of samples, the last stage writes to the output
+    const float* stagein = in + i;
+    for (int s = 0; s < m_stages; s++)
+    {
+      float* stageout = s == m_stages - 1 ? out + i * factor : m_tmp[s & 1];
+      m_stage[s].Up(stagein, stageout, block << s);
+      stagein = stageout;
+    }
+  }
+}
+
+void COversampler::Downsample(const float* in, float* out, int samples)
+{
+  if (m_stages == 0)
+  {
+    if (in != out)
+      memcpy(out, in, samples * sizeof(float));
+    return;
+  }
+
+  int factor = Factor();
+  for (int i = 0; i < samples; i += OS_MAXBLOCK)
+  {
+    int block = Min(samples - i, OS_MAXBLOCK);
+
+    //the stages run in the reverse order, every stage halves the number of samples
+    const float* stagein = in + i * factor;
+    for (int s = m_stages - 1; s >= 0; s--)
+    {
+      float* stageout = s == 0 ? out + i : m_tmp[s & 1];
+      m_stage[s].Down(stagein, stageout, block << s);
+      stagein = stageout;
+    }
+  }
+}
@@ -0,0 +1,101 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef OVERSAMPLER_H
+#define OVERSAMPLER_H
+
+#include "util/ssedefs.h"
+
+#define OS_MAXSTAGES 3
+#define OS_MAXFACTOR (1 << OS_MAXSTAGES)
+
+//Upsample() and Downsample() split their input into blocks of this many samples at the base rate
+#define OS_MAXBLOCK  256
+
+//a half-band filter has 4 * K - 1 taps, of which 2 * K + 1 are not zero
+#define OS_MAXK      16
+
+enum EOSQUALITY
+{
+  OS_LOW,
+  OS_MEDIUM,
+  OS_HIGH,
+  OS_NUMQUALITIES
+};
+
+namespace BobDSPLadspa
+{
+  //one 2x stage, a half-band lowpass that is split into its two polyphase components,
+  //one is a symmetric FIR filter, the other is a delay, since every other tap is zero
+  class CHalfBandStage
+  {
+    public:
+      CHalfBandStage();
+      ~CHalfBandStage();
+
+      void SetLength(int k, double beta);
+      void Reset();
+
+      //Up() writes 2 * samples output samples, Down() reads 2 * samples input samples,
+      //samples must not be more than OS_MAXBLOCK * OS_MAXFACTOR / 2
+      void Up(const float* in, float* out, int samples);
+      void Down(const float* in, float* out, int samples);
+
+      //delay of upsampling and downsampling together, in samples at the higher sample rate
+      int  Delay() { return 4 * m_k - 2; }
+
+    private:
+      int   m_k;
+      float m_coefs[OS_MAXK];
+
+      //the last 2 * m_k - 1 input samples, followed by the current block
+      float m_uphist[2 * OS_MAXK - 1 + OS_MAXBLOCK * OS_MAXFACTOR / 2];
+      float m_downeven[2 * OS_MAXK - 1 + OS_MAXBLOCK * OS_MAXFACTOR / 2];
+      float m_downodd[2 * OS_MAXK - 1 + OS_MAXBLOCK * OS_MAXFACTOR / 2];
+  };
+
+  //runs a nonlinear section of a plugin at 2, 4 or 8 times the sample rate, with a cascade of
+  //half-band stages, later stages use shorter filters since their input has nothing
+  //above the original nyquist frequency
+  class COversampler
+  {
+    public:
+      COversampler();
+      ~COversampler();
+
+      //factor is 1, 2, 4 or 8, changing the factor or the quality resets the oversampler
+      void  SetFactor(int factor, EOSQUALITY quality = OS_MEDIUM);
+      int   Factor() { return 1 << m_stages; }
+      void  Reset();
+
+      //latency of upsampling and downsampling, in samples at the base rate
+      float Latency();
+
+      //Upsample() writes samples * Factor() samples to out, Downsample() reads them from in
+      void  Upsample(const float* in, float* out, int samples);
+      void  Downsample(const float* in, float* out, int samples);
+
+    private:
+      int            m_stages;
+      EOSQUALITY     m_quality;
+      CHalfBandStage m_stage[OS_MAXSTAGES];
+      float          m_tmp[2][OS_MAXBLOCK * OS_MAXFACTOR / 2];
+  };
+}
+
+#endif //OVERSAMPLER_H
@@ -0,0 +1,162 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "parametriceq.h"
+#include "util/ssedefs.h"
+
+using namespace BobDSPLadspa;
+
+CParametricEq::CParametricEq(unsigned long samplerate)
+{
+  m_samplerate = samplerate;
+  m_nractive   = 0;
+  memset(m_ports, 0, sizeof(m_ports));
+  memset(m_active, 0, sizeof(m_active));
+  memset(m_state, 0, sizeof(m_state));
+}
+
+CParametricEq::~CParametricEq()
+{
+}
+
+void CParametricEq::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CParametricEq::Activate()
+{
+  memset(m_state, 0, sizeof(m_state));
+}
+
+//recalculates the coefficients of the bands whose controls changed,
+//and makes a list of the bands that change the signal
+int CParametricEq::UpdateBands()
+{
+  m_nractive = 0;
+  for (int band = 0; band < EQ_NUMBANDS; band++)
+  {
+    bool wasactive = m_coefs[band].IsActive();
+    if (m_coefs[band].CalculateEqBand(m_samplerate, m_ports + EQ_BANDPORT(band)))
+    {
+      //a band that was switched on starts from silence
+      if (!wasactive)
+        m_state[band][0] = m_state[band][1] = 0.0f;
+    }
+
+    if (m_coefs[band].IsActive())
+      m_active[m_nractive++] = band;
+  }
+
+  return m_nractive;
+}
+
+void CParametricEq::Run(unsigned long samplecount)
+{
+  float* in  = m_ports[EQ_IN];
+  float* out = m_ports[EQ_OUT];
+
+  UpdateBands();
+
+  if (m_nractive == 0)
+  {
+    if (in != out)
+      memcpy(out, in, samplecount * sizeof(float));
+    return;
+  }
+
+  //the first pass reads from the input, the following passes filter the output in place,
+  //every pass runs two bands over the whole block, so the buffer is read and written
+  //once for every two bands, and the state of both bands stays in registers
+  int i = 0;
+  for (; i + 1 < m_nractive; i += 2)
+  {
+    RunTwoBands(in, out, samplecount, m_active[i], m_active[i + 1]);
+    in = out;
+  }
+
+  if (i < m_nractive)
+    RunBand(in, out, samplecount, m_active[i]);
+}
+
+void CParametricEq::Deactivate()
+{
+}
+
+bool CParametricEq::IsIdentity()
+{
+  return UpdateBands() == 0;
+}
+
+void CParametricEq::Skipped()
+{
+  //the state is from before the host started skipping, start from silence when running again
+  memset(m_state, 0, sizeof(m_state));
+}
+
+//a1 and a2 are negated, see CBiquadCoef
+void OPTIMIZE CParametricEq::RunBand(float* in, float* out, unsigned long samplecount, int band)
+{
+  const CBiquadCoef& c = m_coefs[band];
+  const float b0 = c.b0, b1 = c.b1, b2 = c.b2, a1 = c.a1, a2 = c.a2;
+  float s1 = m_state[band][0];
+  float s2 = m_state[band][1];
+
+  for (unsigned long i = 0; i < samplecount; i++)
+  {
+    float x = in[i];
+    float y = b0 * x + s1;
+    s1 = b1 * x + a1 * y + s2;
+    s2 = b2 * x + a2 * y;
+    out[i] = y;
+  }
+
+  m_state[band][0] = s1;
+  m_state[band][1] = s2;
+}
+
+void OPTIMIZE CParametricEq::RunTwoBands(float* in, float* out, unsigned long samplecount, int band1, int band2)
+{
+  const CBiquadCoef& c = m_coefs[band1];
+  const CBiquadCoef& d = m_coefs[band2];
+  const float cb0 = c.b0, cb1 = c.b1, cb2 = c.b2, ca1 = c.a1, ca2 = c.a2;
+  const float db0 = d.b0, db1 = d.b1, db2 = d.b2, da1 = d.a1, da2 = d.a2;
+  float cs1 = m_state[band1][0];
+  float cs2 = m_state[band1][1];
+  float ds1 = m_state[band2][0];
+  float ds2 = m_state[band2][1];
+
+  for (unsigned long i = 0; i < samplecount; i++)
+  {
+    float x = in[i];
+    float y = cb0 * x + cs1;
+    cs1 = cb1 * x + ca1 * y + cs2;
+    cs2 = cb2 * x + ca2 * y;
+
+    float z = db0 * y + ds1;
+    ds1 = db1 * y + da1 * z + ds2;
+    ds2 = db2 * y + da2 * z;
+    out[i] = z;
+  }
+
+  m_state[band1][0] = cs1;
+  m_state[band1][1] = cs2;
+  m_state[band2][0] = ds1;
+  m_state[band2][1] = ds2;
+}
@@ -0,0 +1,67 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef PARAMETRICEQ_H
+#define PARAMETRICEQ_H
+
+#include "config.h"
+#include "biquadcoefs.h"
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+
+#define EQ_IN       0
+#define EQ_OUT      1
+#define EQ_NUMBANDS 10
+
+//every band has a type, frequency, Q and gain port
+#define EQ_BANDPORTS 4
+#define EQ_BANDPORT(band) (2 + (band) * EQ_BANDPORTS)
+#define EQ_NUMPORTS EQ_BANDPORT(EQ_NUMBANDS)
+
+namespace BobDSPLadspa
+{
+  class CParametricEq : public IFilter
+  {
+    public:
+      CParametricEq(unsigned long samplerate);
+      ~CParametricEq();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+      bool IsIdentity();
+      void Skipped();
+
+    private:
+      int  UpdateBands();
+      void RunBand(float* in, float* out, unsigned long samplecount, int band);
+      void RunTwoBands(float* in, float* out, unsigned long samplecount, int band1, int band2);
+
+      float        m_samplerate;
+      LADSPA_Data* m_ports[EQ_NUMPORTS];
+      CBiquadCoef  m_coefs[EQ_NUMBANDS];
+      int          m_active[EQ_NUMBANDS]; //indices of the bands that change the signal
+      int          m_nractive;
+
+      //transposed direct form II state of every band
+      float        m_state[EQ_NUMBANDS][2];
+  };
+}
+
+#endif //PARAMETRICEQ_H
@@ -50,24 +50,50 @@ void CPwm::Activate()
   m_accumulator = 0.0;
   m_accumsamples = 0;
   m_outval = 0;
+  m_oversampler.Reset();
 }
 
 void CPwm::Run(unsigned long samplecount)
 {
-  LADSPA_Data* in = m_ports[0];
-  LADSPA_Data* inend = in + samplecount;
-  LADSPA_Data* out = m_ports[1];
+  //the pulses have hard edges, which alias, when oversampling they are made at a higher
+  //sample rate, and the downsampling filter removes everything above the nyquist frequency
+  int factor = 1 << Clamp(Round32(*(m_ports[3])), 0, OS_MAXSTAGES);
+  m_oversampler.SetFactor(factor);
 
-  uint32_t period = Clamp(Round32(*(m_ports[2])), 1, 0xFFFFFFF);
+  //the period is in samples at the base rate
+  uint32_t period = Clamp(Round32(*(m_ports[2])), 1, 0xFFFFFFF / OS_MAXFACTOR) * factor;
+
+  if (factor == 1)
+  {
+    RunPwm(m_ports[0], m_ports[1], samplecount, period);
+    return;
+  }
+
+  float buf[OS_MAXBLOCK * OS_MAXFACTOR];
+  for (unsigned long i = 0; i < samplecount; i += OS_MAXBLOCK)
+  {
+    int block = Min(samplecount - i, (unsigned long)OS_MAXBLOCK);
+    m_oversampler.Upsample(m_ports[0] + i, buf, block);
+    RunPwm(buf, buf, block * factor, period);
+    m_oversampler.Downsample(buf, m_ports[1] + i, block);
+  }
+}
+
+//in and out may be the same buffer
+void CPwm::RunPwm(float* in, float* out, unsigned long samplecount, uint32_t period)
+{
+  float* inend = in + samplecount;
 
   while (in != inend)
   {
+    float sample = *in;
+
     if (m_samplecounter < m_outval)
       *out = m_state;
     else
       *out = 0.0f;
 
-    m_accumulator += fabs(*in);
+    m_accumulator += fabs(sample);
     m_accumsamples++;
     m_samplecounter++;
     if (m_samplecounter >= period)
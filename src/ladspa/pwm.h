@@ -22,6 +22,7 @@
 #include "util/inclstdint.h"
 #include "filterdescriptions.h"
 #include "filterinterface.h"
+#include "oversampler.h"
 
 namespace BobDSPLadspa
 {
@@ -37,13 +38,16 @@ namespace BobDSPLadspa
       void Deactivate();
 
     private:
+      void RunPwm(float* in, float* out, unsigned long samplecount, uint32_t period);
+
       unsigned long m_samplerate;
-      LADSPA_Data*  m_ports[3];
+      LADSPA_Data*  m_ports[4];
       float         m_state;
       uint32_t      m_samplecounter;
       double        m_accumulator;
       uint32_t      m_accumsamples;
       uint32_t      m_outval;
+      COversampler  m_oversampler;
   };
 }
 
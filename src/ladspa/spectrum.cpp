@@ -0,0 +1,385 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <errno.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "spectrum.h"
+#include "util/misc.h"
+#include "util/ssedefs.h"
+
+using namespace BobDSPLadspa;
+
+//a frame is transformed every quarter of the fft size
+#define SPEC_OVERLAP   4
+
+//center frequencies are 1000 * 2^(k / bandsperoctave), the lowest band is 17 thirds below 1 KHz
+#define SPEC_LOWBAND   -17
+#define SPEC_3RDBANDS  31
+
+CSpectrum::CSpectrum(unsigned long samplerate) : m_fft(SPEC_MAXFFTSIZE)
+{
+  m_samplerate = samplerate;
+  memset(m_ports, 0, sizeof(m_ports));
+
+  //about a third of a second, so that the low bands have some bins
+  m_size = SPEC_MINFFTSIZE;
+  while (m_size < SPEC_MAXFFTSIZE && m_size * 3 < m_samplerate)
+    m_size *= 2;
+
+  m_fft.SetSize(m_size);
+  m_bins = m_size / 2 + 1;
+
+  m_ring   = (float*)aligned_alloc(ALIGN, m_size * sizeof(float));
+  m_window = (float*)aligned_alloc(ALIGN, m_size * sizeof(float));
+  m_frame  = (float*)aligned_alloc(ALIGN, m_size * sizeof(float));
+  m_re     = (float*)aligned_alloc(ALIGN, (m_size / 2 + ALIGN / sizeof(float)) * sizeof(float));
+  m_im     = (float*)aligned_alloc(ALIGN, (m_size / 2 + ALIGN / sizeof(float)) * sizeof(float));
+  m_power  = (float*)aligned_alloc(ALIGN, (m_size / 2 + ALIGN / sizeof(float)) * sizeof(float));
+
+  for (int i = 0; i < m_size; i++)
+    m_window[i] = 0.5 - 0.5 * cos(2.0 * M_PI * i / m_size);
+
+  //touch the frame buffer here, so that the first frame doesn't page fault in the realtime thread
+  memset(m_frame, 0, m_size * sizeof(float));
+
+  m_sixth = -1;
+  m_busy  = false;
+  m_stop  = false;
+  SetBands(false);
+  Activate();
+
+  //the analyser can skip frames, so the thread doesn't need realtime priority
+  sem_init(&m_start, 0, 0);
+  sem_init(&m_done, 0, 0);
+  pthread_create(&m_thread, NULL, ThreadFunction, this);
+}
+
+CSpectrum::~CSpectrum()
+{
+  m_stop = true;
+  sem_post(&m_start);
+  pthread_join(m_thread, NULL);
+  sem_destroy(&m_start);
+  sem_destroy(&m_done);
+
+  free(m_ring);
+  free(m_window);
+  free(m_frame);
+  free(m_re);
+  free(m_im);
+  free(m_power);
+}
+
+void CSpectrum::ConnectPort(unsigned long port, LADSPA_Data* datalocation)
+{
+  m_ports[port] = datalocation;
+}
+
+void CSpectrum::Activate()
+{
+  //this isn't called from the realtime thread, so it can wait for the frame to finish
+  WaitFrame(true);
+
+  memset(m_ring, 0, m_size * sizeof(float));
+  memset(m_average, 0, sizeof(m_average));
+  m_pos  = 0;
+  m_fill = 0;
+  m_hops = 0;
+
+  for (int band = 0; band < SPEC_MAXBANDS; band++)
+  {
+    m_levels[band] = SPEC_FLOOR;
+    m_output[band] = SPEC_FLOOR;
+  }
+}
+
+void CSpectrum::Deactivate()
+{
+}
+
+void CSpectrum::SetBands(bool sixth)
+{
+  if ((int)sixth == m_sixth)
+    return;
+
+  m_sixth   = sixth;
+  m_nrbands = sixth ? SPEC_MAXBANDS : SPEC_3RDBANDS;
+
+  int    bandsperoctave = sixth ? 6 : 3;
+  double binwidth       = (double)m_samplerate / m_size;
+
+  for (int band = 0; band < SPEC_MAXBANDS; band++)
+  {
+    //the bands are compared to bin j, which covers j - 0.5 to j + 0.5 in bins
+    int    k      = band + SPEC_LOWBAND * bandsperoctave / 3;
+    double center = 1000.0 * pow(2.0, (double)k / bandsperoctave);
+    double low    = center * pow(2.0, -0.5 / bandsperoctave) / binwidth;
+    double high   = center * pow(2.0, 0.5 / bandsperoctave) / binwidth;
+    int    first  = floor(low + 0.5);
+    int    last   = floor(high + 0.5);
+
+    if (band >= m_nrbands || first >= m_bins)
+    {
+      //bands that are not used, or above the nyquist frequency, are empty
+      m_firstbin[band]    = 0;
+      m_lastbin[band]     = -1;
+      m_firstweight[band] = 0.0f;
+      m_lastweight[band]  = 0.0f;
+    }
+    else if (first == last)
+    {
+      m_firstbin[band]    = first;
+      m_lastbin[band]     = last;
+      m_firstweight[band] = high - low;
+      m_lastweight[band]  = 0.0f;
+    }
+    else
+    {
+      last = Min(last, m_bins - 1);
+      m_firstbin[band]    = first;
+      m_lastbin[band]     = last;
+      m_firstweight[band] = first + 0.5 - low;
+      m_lastweight[band]  = Min(high - (last - 0.5), 1.0);
+    }
+
+    m_average[band] = 0.0f;
+    m_levels[band]  = SPEC_FLOOR;
+  }
+}
+
+void CSpectrum::Run(unsigned long samplecount)
+{
+  //the band tables and levels can only be used when the thread is done with the previous frame
+  if (!WaitFrame(false))
+  {
+    SetBands(*m_ports[SPEC_SIXTH] > 0.5f);
+    memcpy(m_output, m_levels, sizeof(m_output));
+  }
+
+  //the input is only copied here, the fft is done in the thread once every hop
+  int          hop = m_size / SPEC_OVERLAP;
+  LADSPA_Data* in  = m_ports[SPEC_IN];
+  while (samplecount > 0)
+  {
+    int samples = Min((int)samplecount, m_size - m_pos, hop - m_fill);
+    memcpy(m_ring + m_pos, in, samples * sizeof(float));
+
+    in          += samples;
+    samplecount -= samples;
+    m_fill      += samples;
+    m_pos       += samples;
+    if (m_pos == m_size)
+      m_pos = 0;
+
+    if (m_fill == hop)
+    {
+      m_hops++;
+      m_fill = 0;
+      if (!WaitFrame(false))
+        StartFrame();
+    }
+  }
+
+  for (int band = 0; band < SPEC_MAXBANDS; band++)
+    *m_ports[SPEC_BAND1 + band] = m_output[band];
+}
+
+//returns whether the thread is still busy, if block is true it waits for it to finish
+bool CSpectrum::WaitFrame(bool block)
+{
+  if (m_busy)
+  {
+    if (block)
+    {
+      while (sem_wait(&m_done) != 0 && errno == EINTR);
+      m_busy = false;
+    }
+    else if (sem_trywait(&m_done) == 0)
+    {
+      m_busy = false;
+    }
+  }
+
+  return m_busy;
+}
+
+void* CSpectrum::ThreadFunction(void* arg)
+{
+  CSpectrum* spectrum = (CSpectrum*)arg;
+  for(;;)
+  {
+    while (sem_wait(&spectrum->m_start) != 0 && errno == EINTR);
+
+    if (spectrum->m_stop)
+      break;
+
+    spectrum->ProcessFrame();
+    sem_post(&spectrum->m_done);
+  }
+
+  return NULL;
+}
+
+static void OPTIMIZE MultiplyWindow(const float* in, const float* window, float* out, int samples)
+{
+  int i = 0;
+#ifdef USE_SSE
+  for (; i + 3 < samples; i += 4)
+    _mm_storeu_ps(out + i, _mm_mul_ps(_mm_loadu_ps(in + i), _mm_loadu_ps(window + i)));
+#endif
+  for (; i < samples; i++)
+    out[i] = in[i] * window[i];
+}
+
+static void OPTIMIZE Power(const float* re, const float* im, float* power, float scale, int bins)
+{
+  int i = 0;
+#ifdef USE_SSE
+  __m128 scalevec = _mm_set1_ps(scale);
+  for (; i + 3 < bins; i += 4)
+  {
+    __m128 r = _mm_load_ps(re + i);
+    __m128 m = _mm_load_ps(im + i);
+    _mm_store_ps(power + i, _mm_mul_ps(_mm_add_ps(_mm_mul_ps(r, r), _mm_mul_ps(m, m)), scalevec));
+  }
+#endif
+  for (; i < bins; i++)
+    power[i] = (re[i] * re[i] + im[i] * im[i]) * scale;
+}
+
+static float OPTIMIZE Sum(const float* in, int samples)
+{
+  float sum = 0.0f;
+  int   i   = 0;
+#ifdef USE_SSE
+  __m128 sumvec = _mm_setzero_ps();
+  for (; i + 3 < samples; i += 4)
+    sumvec = _mm_add_ps(sumvec, _mm_loadu_ps(in + i));
+
+  ssevec sums;
+  sums.v = sumvec;
+  sum = sums.f[0] + sums.f[1] + sums.f[2] + sums.f[3];
+#endif
+  for (; i < samples; i++)
+    sum += in[i];
+
+  return sum;
+}
+
+//copies the windowed ring to m_frame, and hands it to the thread
+void CSpectrum::StartFrame()
+{
+  //m_pos is the oldest sample in the ring
+  int first = m_size - m_pos;
+  MultiplyWindow(m_ring + m_pos, m_window, m_frame, first);
+  MultiplyWindow(m_ring, m_window + first, m_frame + first, m_pos);
+
+  //exponential averaging with the time constant from the averaging control,
+  //frames that were skipped count as well, so the time constant doesn't change
+  float avgtime = Max(*m_ports[SPEC_AVERAGING], 1.0f) / 1000.0f;
+  m_avgcoef = 1.0f - expf(-(m_hops * m_size / SPEC_OVERLAP) / (avgtime * m_samplerate));
+  m_hops    = 0;
+
+  m_busy = true;
+  sem_post(&m_start);
+}
+
+void CSpectrum::ProcessFrame()
+{
+  m_fft.RealForward(m_frame, m_re, m_im);
+
+  //the hann window has a mean square of 3/8, the bins are doubled for the negative frequencies,
+  //and the power is doubled again so that a full scale sine is 0 dB
+  Power(m_re, m_im, m_power, 32.0f / (3.0f * m_size * m_size), m_bins);
+
+  for (int band = 0; band < m_nrbands; band++)
+  {
+    int firstbin = m_firstbin[band];
+    int lastbin  = m_lastbin[band];
+    if (lastbin < firstbin)
+      continue;
+
+    float power = m_power[firstbin] * m_firstweight[band];
+    if (lastbin > firstbin)
+    {
+      power += Sum(m_power + firstbin + 1, lastbin - firstbin - 1);
+      power += m_power[lastbin] * m_lastweight[band];
+    }
+
+    m_average[band] += (power - m_average[band]) * m_avgcoef;
+    if (m_average[band] > 0.0f)
+      m_levels[band] = Max(10.0f * log10f(m_average[band]), SPEC_FLOOR);
+    else
+      m_levels[band] = SPEC_FLOOR;
+  }
+}
+
+const LADSPA_PortDescriptor* CSpectrum::PortDescriptors()
+{
+  static LADSPA_PortDescriptor descriptors[SPEC_NUMPORTS];
+
+  descriptors[SPEC_IN]        = LADSPA_PORT_INPUT | LADSPA_PORT_AUDIO;
+  descriptors[SPEC_SIXTH]     = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+  descriptors[SPEC_AVERAGING] = LADSPA_PORT_INPUT | LADSPA_PORT_CONTROL;
+  for (int band = 0; band < SPEC_MAXBANDS; band++)
+    descriptors[SPEC_BAND1 + band] = LADSPA_PORT_OUTPUT | LADSPA_PORT_CONTROL;
+
+  return descriptors;
+}
+
+const char* const* CSpectrum::PortNames()
+{
+  static char        bandnames[SPEC_MAXBANDS][16];
+  static const char* names[SPEC_NUMPORTS];
+
+  names[SPEC_IN]        = "Input";
+  names[SPEC_SIXTH]     = "1/6 octave bands";
+  names[SPEC_AVERAGING] = "Averaging (ms)";
+  for (int band = 0; band < SPEC_MAXBANDS; band++)
+  {
+    snprintf(bandnames[band], sizeof(bandnames[band]), "Band %i (dB)", band + 1);
+    names[SPEC_BAND1 + band] = bandnames[band];
+  }
+
+  return names;
+}
+
+const LADSPA_PortRangeHint* CSpectrum::PortRangeHints()
+{
+  static LADSPA_PortRangeHint hints[SPEC_NUMPORTS];
+
+  memset(hints, 0, sizeof(hints));
+
+  hints[SPEC_SIXTH].HintDescriptor = LADSPA_HINT_TOGGLED | LADSPA_HINT_DEFAULT_0;
+
+  hints[SPEC_AVERAGING].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW | LADSPA_HINT_BOUNDED_ABOVE |
+                                         LADSPA_HINT_LOGARITHMIC   | LADSPA_HINT_DEFAULT_MIDDLE;
+  hints[SPEC_AVERAGING].LowerBound = 10.0f;
+  hints[SPEC_AVERAGING].UpperBound = 10000.0f;
+
+  for (int band = 0; band < SPEC_MAXBANDS; band++)
+  {
+    hints[SPEC_BAND1 + band].HintDescriptor = LADSPA_HINT_BOUNDED_BELOW;
+    hints[SPEC_BAND1 + band].LowerBound     = SPEC_FLOOR;
+  }
+
+  return hints;
+}
@@ -0,0 +1,116 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef SPECTRUM_H
+#define SPECTRUM_H
+
+#include <pthread.h>
+#include <semaphore.h>
+
+#include "filterdescriptions.h"
+#include "filterinterface.h"
+#include "fft.h"
+
+#define SPEC_IN         0
+#define SPEC_SIXTH      1
+#define SPEC_AVERAGING  2
+#define SPEC_BAND1      3
+
+//1/6 octave bands from 20 Hz to 20 KHz, with 1/3 octave bands only the first 31 are used
+#define SPEC_MAXBANDS   61
+#define SPEC_NUMPORTS   (SPEC_BAND1 + SPEC_MAXBANDS)
+
+#define SPEC_MINFFTSIZE 1024
+#define SPEC_MAXFFTSIZE 65536
+
+//value of the band outputs when there's no signal, or the band is above the nyquist frequency
+#define SPEC_FLOOR      -140.0f
+
+namespace BobDSPLadspa
+{
+  //spectrum analyser, the input is stored in a ring buffer, and every half fft size a hann
+  //windowed frame is transformed, the power of the bins is summed into 1/3 or 1/6 octave bands,
+  //and averaged over the frames, the band levels are in dB relative to a full scale sine
+  //
+  //the fft size is about a third of the sample rate, so the 1/3 octave bands at 20 Hz are
+  //a few bins wide, the narrowest bands get the power of the part of a bin they overlap
+  //
+  //the fft and the band sums run in a separate thread, Run() only copies the input and
+  //the windowed frames, when the thread is still busy with the previous frame a frame is skipped
+  class CSpectrum : public IFilter
+  {
+    public:
+      CSpectrum(unsigned long samplerate);
+      ~CSpectrum();
+
+      void ConnectPort(unsigned long port, LADSPA_Data* datalocation);
+      void Activate();
+      void Run(unsigned long samplecount);
+      void Deactivate();
+
+      //the band outputs are generated, since there are so many of them
+      static const LADSPA_PortDescriptor* PortDescriptors();
+      static const char* const*           PortNames();
+      static const LADSPA_PortRangeHint*  PortRangeHints();
+
+    private:
+      void SetBands(bool sixth);
+      void StartFrame();
+      bool WaitFrame(bool block);
+      void ProcessFrame();
+
+      static void* ThreadFunction(void* arg);
+
+      float        m_samplerate;
+      LADSPA_Data* m_ports[SPEC_NUMPORTS];
+      CFFT         m_fft;
+      int          m_size;
+      int          m_bins;
+      int          m_pos;  //write position in m_ring
+      int          m_fill; //samples written since the last frame
+
+      float*       m_ring;
+      float*       m_window;
+      float*       m_frame;
+      float*       m_re;
+      float*       m_im;
+      float*       m_power;
+
+      int          m_sixth;
+      int          m_nrbands;
+      //first and last bin of every band, and how much of these two bins is in the band
+      int          m_firstbin[SPEC_MAXBANDS];
+      int          m_lastbin[SPEC_MAXBANDS];
+      float        m_firstweight[SPEC_MAXBANDS];
+      float        m_lastweight[SPEC_MAXBANDS];
+
+      float        m_average[SPEC_MAXBANDS]; //averaged power
+      float        m_levels[SPEC_MAXBANDS];  //averaged power in dB
+      float        m_output[SPEC_MAXBANDS];  //copy of m_levels from the last finished frame
+
+      pthread_t     m_thread;
+      sem_t         m_start;
+      sem_t         m_done;
+      volatile bool m_stop;
+      bool          m_busy;    //while the thread processes m_frame it owns the band tables, averages and levels
+      int           m_hops;    //hops since the last frame that was processed
+      float         m_avgcoef; //averaging coefficient for the frame in m_frame
+  };
+}
+
+#endif //SPECTRUM_H
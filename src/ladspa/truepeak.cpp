@@ -0,0 +1,115 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "truepeak.h"
+#include "util/misc.h"
+
+using namespace BobDSPLadspa;
+
+CTruePeak::CTruePeak()
+{
+  //phase p of tap j is a blackman windowed sinc at j - TP_LATENCY + p / TP_PHASES,
+  //so phase 0 passes input sample i - TP_LATENCY, and phase p interpolates the value
+  //p / TP_PHASES samples after it
+  const double width = TP_LATENCY + 1.0 / TP_PHASES;
+  for (int j = 0; j < TP_TAPS; j++)
+  {
+    for (int p = 0; p < TP_PHASES; p++)
+    {
+      double t      = j - TP_LATENCY + (double)p / TP_PHASES;
+      double sinc   = t == 0.0 ? 1.0 : sin(M_PI * t) / (M_PI * t);
+      double window = 0.42 + 0.5 * cos(M_PI * t / width) + 0.08 * cos(2.0 * M_PI * t / width);
+      m_coefs[j][p] = sinc * window;
+    }
+  }
+
+  Reset();
+}
+
+CTruePeak::~CTruePeak()
+{
+}
+
+void CTruePeak::Reset()
+{
+  memset(m_buf, 0, sizeof(m_buf));
+  m_prevseg = 0.0f;
+}
+
+void CTruePeak::Process(const float* in, float* peak, int samples)
+{
+  while (samples > 0)
+  {
+    int block = Min(samples, TP_BLOCK);
+
+    memcpy(m_buf + TP_TAPS - 1, in, block * sizeof(float));
+    ProcessBlock(peak, block);
+    memmove(m_buf, m_buf + block, (TP_TAPS - 1) * sizeof(float));
+
+    in      += block;
+    peak    += block;
+    samples -= block;
+  }
+}
+
+void OPTIMIZE CTruePeak::ProcessBlock(float* peak, int samples)
+{
+  const float* x = m_buf + TP_TAPS - 1;
+
+#ifdef USE_SSE
+  __m128 coefs[TP_TAPS];
+  for (int j = 0; j < TP_TAPS; j++)
+    coefs[j] = _mm_loadu_ps(m_coefs[j]);
+
+  __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+
+  for (int i = 0; i < samples; i++)
+  {
+    __m128 sum0 = _mm_mul_ps(coefs[0], _mm_set1_ps(x[i]));
+    __m128 sum1 = _mm_mul_ps(coefs[1], _mm_set1_ps(x[i - 1]));
+    for (int j = 2; j < TP_TAPS; j += 2)
+    {
+      sum0 = _mm_add_ps(sum0, _mm_mul_ps(coefs[j], _mm_set1_ps(x[i - j])));
+      sum1 = _mm_add_ps(sum1, _mm_mul_ps(coefs[j + 1], _mm_set1_ps(x[i - j - 1])));
+    }
+
+    ssevec v;
+    v.v = _mm_and_ps(_mm_add_ps(sum0, sum1), absmask);
+
+    float seg = Max(Max(v.f[1], v.f[2]), v.f[3]);
+    peak[i]   = Max(peak[i], Max(v.f[0], Max(seg, m_prevseg)));
+    m_prevseg = seg;
+  }
+#else
+  for (int i = 0; i < samples; i++)
+  {
+    float sum[TP_PHASES] = {};
+    for (int j = 0; j < TP_TAPS; j++)
+    {
+      for (int p = 0; p < TP_PHASES; p++)
+        sum[p] += m_coefs[j][p] * x[i - j];
+    }
+
+    float seg = Max(Max(fabsf(sum[1]), fabsf(sum[2])), fabsf(sum[3]));
+    peak[i]   = Max(peak[i], Max(fabsf(sum[0]), Max(seg, m_prevseg)));
+    m_prevseg = seg;
+  }
+#endif
+}
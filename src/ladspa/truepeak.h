@@ -0,0 +1,61 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef TRUEPEAK_H
+#define TRUEPEAK_H
+
+#include "util/ssedefs.h"
+
+//4x oversampling with 12 taps per phase
+#define TP_PHASES  4
+#define TP_TAPS    12
+#define TP_LATENCY (TP_TAPS / 2)
+#define TP_BLOCK   256
+
+namespace BobDSPLadspa
+{
+  //estimates the peaks of the continuous signal between the samples, by interpolating
+  //3 values between every two samples with a polyphase windowed sinc filter
+  class CTruePeak
+  {
+    public:
+      CTruePeak();
+      ~CTruePeak();
+
+      void Reset();
+
+      //peak[i] is set to the maximum of itself and the absolute value of input sample i - TP_LATENCY,
+      //and the interpolated values between it and its neighbours, so that the peaks of multiple
+      //channels can be found by running every channel on the same peak buffer
+      void Process(const float* in, float* peak, int samples);
+
+    private:
+      void ProcessBlock(float* peak, int samples);
+
+      //the coefficients for tap j of all phases, phase 0 is the input sample itself
+      float m_coefs[TP_TAPS][TP_PHASES];
+
+      //the last TP_TAPS - 1 input samples, followed by the current block
+      float m_buf[TP_TAPS - 1 + TP_BLOCK];
+
+      //highest interpolated value between the previous two samples
+      float m_prevseg;
+  };
+}
+
+#endif //TRUEPEAK_H
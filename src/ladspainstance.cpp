@@ -24,6 +24,7 @@
 
 #include <cstdlib>
 #include <cstring>
+#include <cmath>
 #include <assert.h>
 
 using namespace std;
@@ -34,6 +35,9 @@ CPort::CPort(jack_port_t* jackport, unsigned long ladspaport, bool isinput)
   m_ladspaport = ladspaport;
   m_isinput    = isinput;
   m_buf        = NULL;
+  m_jackbuf    = NULL;
+  m_runbuf     = NULL;
+  m_bypassport = -1;
 }
 
 CPort::~CPort()
@@ -80,6 +84,10 @@ CLadspaInstance::CLadspaInstance(jack_client_t* client, const std::string& name,
   m_buffersize     = buffersize;
   m_activated      = false;
   m_handle         = NULL;
+  m_bypass         = false;
+  m_freewheel      = false;
+  m_rtpriority     = -1;
+  m_bypassgain     = 0.0f;
 }
 
 CLadspaInstance::~CLadspaInstance()
@@ -97,6 +105,11 @@ bool CLadspaInstance::Connect()
     return false;
   }
 
+  //tell the plugin the realtime priority of the jack thread, for its worker threads
+  m_rtpriority = jack_client_real_time_priority(m_client);
+  m_freewheel  = false;
+  m_plugin->SetRealtimePriority(m_handle, m_rtpriority);
+
   //connect the control ports
   for (unsigned long port = 0; port < m_plugin->PortCount(); port++)
   {
@@ -160,11 +173,44 @@ bool CLadspaInstance::Connect()
     }
   }
 
+  //when bypassed, the first audio input is copied to the first audio output, the second input
+  //to the second output, and so on, outputs without a matching input are silent
+  vector<CPort>::iterator input = m_ports.begin();
+  for (vector<CPort>::iterator it = m_ports.begin(); it != m_ports.end(); it++)
+  {
+    if (!it->IsInput())
+    {
+      while (input != m_ports.end() && !input->IsInput())
+        input++;
+
+      if (input != m_ports.end())
+      {
+        it->SetBypassPort(input - m_ports.begin());
+        input++;
+      }
+    }
+  }
+
   AllocateBuffers(m_buffersize);
 
   return true;
 }
 
+//appends the values of the control output ports, in the order of the ladspa plugin's ports
+//the values are read while the jack thread might write them, which is fine for meters
+void CLadspaInstance::GetControlOutputs(std::vector<float>& values)
+{
+  for (unsigned long port = 0; port < m_plugin->PortCount(); port++)
+  {
+    if (m_plugin->IsControlOutput(port))
+    {
+      controlmap::iterator it = m_controloutputs.find(m_plugin->PortName(port));
+      assert(it != m_controloutputs.end());
+      values.push_back(it->second.FloatOut());
+    }
+  }
+}
+
 void CLadspaInstance::Disconnect()
 {
   //deactivate and clean up the ladspa plugin
@@ -216,8 +262,71 @@ void CLadspaInstance::AllocateBuffers(int buffersize)
     it->AllocateBuffer(buffersize);
 }
 
-//this is called from the jack client thread
-void CLadspaInstance::Run(jack_nframes_t jackframes, int frames, int offset, float pregain, float postgain)
+void CLadspaInstance::WarmUp(int samples)
+{
+  if (!m_handle || !m_activated || m_buffersize <= 0)
+    return;
+
+#ifdef USE_SSE
+  _MM_SET_FLUSH_ZERO_MODE (_MM_FLUSH_ZERO_ON);
+#endif
+
+  //connect every audio port to its own temp buffer, the input buffers are filled with silence
+  for (vector<CPort>::iterator it = m_ports.begin(); it != m_ports.end(); it++)
+  {
+    float* buf = it->GetBuffer(NULL);
+    memset(buf, 0, m_buffersize * sizeof(float));
+    m_plugin->Descriptor()->connect_port(m_handle, it->GetLadspaPort(), buf);
+  }
+
+  //run the plugin for at least the given number of samples before the jack client is activated,
+  //so that every internal block of the plugin is processed at least once, this makes sure that any
+  //state the plugin allocates or initializes on its first run, and the memory it touches while processing,
+  //is paged in and cached so that the first periods in the jack thread don't cause xruns
+  //
+  //the plugin may hand work to its own threads on its first run, like loading an impulse response,
+  //so it's told this isn't realtime, which lets it wait on them, then it's run again after that
+  //work is done, so that the result is used and warmed up as well
+  int periods = Max((samples + m_buffersize - 1) / m_buffersize, 1);
+  SetFreewheel(true);
+
+  for (int i = 0; i < periods; i++)
+    m_plugin->Descriptor()->run(m_handle, m_buffersize);
+
+  m_plugin->WaitLoaded(m_handle);
+
+  for (int i = 0; i < periods; i++)
+    m_plugin->Descriptor()->run(m_handle, m_buffersize);
+
+  SetFreewheel(false);
+
+  //reset the plugin state, so that processing starts clean
+  Deactivate();
+  Activate();
+}
+
+#define BYPASSFADETIME 0.01f
+
+//this is called from the jack client thread, once per period before Run(), and by WarmUp(),
+//while jackd is freewheeling the thread isn't realtime, so the plugin may wait on its worker threads
+void CLadspaInstance::SetFreewheel(bool freewheel)
+{
+  if (freewheel != m_freewheel)
+  {
+    m_freewheel = freewheel;
+    m_plugin->SetRealtimePriority(m_handle, freewheel ? -1 : m_rtpriority);
+  }
+}
+
+//this is called from the jack client thread, once per period before Run()
+void CLadspaInstance::GetJackBuffers(jack_nframes_t jackframes)
+{
+  for (vector<CPort>::iterator it = m_ports.begin(); it != m_ports.end(); it++)
+    it->SetJackBuffer((float*)jack_port_get_buffer(it->GetJackPort(), jackframes));
+}
+
+//this is called from the jack client thread, for every block of the period
+void CLadspaInstance::Run(int frames, int offset, float pregain, float postgain)
 {
 #ifdef USE_SSE
   //set the flush-to-zero flag, denormal floats will be written as zero
@@ -227,7 +336,7 @@ void CLadspaInstance::Run(jack_nframes_t jackframes, int frames, int offset, flo
 
   for (vector<CPort>::iterator it = m_ports.begin(); it != m_ports.end(); it++)
   {
-    float* jackptr = (float*)jack_port_get_buffer(it->GetJackPort(), jackframes) + offset;
+    float* jackptr = it->GetJackBuffer() + offset;
 
     if (it->IsInput())
     {
@@ -239,11 +348,13 @@ void CLadspaInstance::Run(jack_nframes_t jackframes, int frames, int offset, flo
 
         //connect the ladspa port to the temp buffer
         m_plugin->Descriptor()->connect_port(m_handle, it->GetLadspaPort(), buf);
+        it->SetRunBuffer(buf);
       }
       else
       {
         //no gain needed, connect the ladspa port directly to the jack buffer
         m_plugin->Descriptor()->connect_port(m_handle, it->GetLadspaPort(), jackptr);
+        it->SetRunBuffer(jackptr);
       }
     }
     else
@@ -251,18 +362,64 @@ void CLadspaInstance::Run(jack_nframes_t jackframes, int frames, int offset, flo
       //connect the ladspa output port to the jack output port
       //gain is applied directly on the jack output buffer afterwards
       m_plugin->Descriptor()->connect_port(m_handle, it->GetLadspaPort(), jackptr);
+      it->SetRunBuffer(jackptr);
     }
   }
 
-  //run the ladspa plugin on the audio data
-  m_plugin->Descriptor()->run(m_handle, frames);
+  //when the plugin says its outputs are equal to its inputs with the current controls
+  //treat it the same as bypassed, the input is copied to the output without running it
+  bool bypass = m_bypass || m_plugin->IsIdentity(m_handle);
+
+  //when the bypass state changes, fade between the plugin output and the input
+  //when fully bypassed, the plugin doesn't need to run
+  bool  runplugin  = !bypass || m_bypassgain != 1.0f;
+  float target     = bypass ? 1.0f : 0.0f;
+  float fadegain   = m_bypassgain;
+  float fadestep   = 0.0f;
+  int   fadeframes = 0;
+  if (m_bypassgain != target)
+  {
+    fadestep = 1.0f / (BYPASSFADETIME * m_samplerate);
+    float remaining = Abs(target - m_bypassgain);
+    fadeframes = Min((int)ceilf(remaining / fadestep), frames);
+
+    if (fadeframes == frames && remaining > fadestep * frames)
+      m_bypassgain += bypass ? fadestep * frames : -fadestep * frames;
+    else
+      m_bypassgain = target;
+
+    if (!bypass)
+      fadestep = -fadestep;
+  }
+
+  //run the ladspa plugin on the audio data, or tell it that it was skipped
+  if (runplugin)
+    m_plugin->Descriptor()->run(m_handle, frames);
+  else
+    m_plugin->Skipped(m_handle);
 
   //postprocess
   for (vector<CPort>::iterator it = m_ports.begin(); it != m_ports.end(); it++)
   {
     if (!it->IsInput())
     {
-      float* jackptr = (float*)jack_port_get_buffer(it->GetJackPort(), jackframes) + offset;
+      float* jackptr = it->GetRunBuffer();
+      float* inptr   = NULL;
+      if (it->GetBypassPort() != -1)
+        inptr = m_ports[it->GetBypassPort()].GetRunBuffer();
+
+      if (fadeframes > 0)
+        CrossFade(inptr, jackptr, fadeframes, fadegain, fadestep);
+
+      //when bypassed, copy the input to the output, or write silence if there's no input
+      if (!runplugin || (bypass && fadeframes < frames))
+      {
+        int start = runplugin ? fadeframes : 0;
+        if (inptr)
+          memcpy(jackptr + start, inptr + start, (frames - start) * sizeof(float));
+        else
+          memset(jackptr + start, 0, (frames - start) * sizeof(float));
+      }
 
 #ifndef USE_SSE
       //set denormals of output buffers to zero
@@ -275,4 +432,3 @@ void CLadspaInstance::Run(jack_nframes_t jackframes, int frames, int offset, flo
     }
   }
 }
-
@@ -71,6 +71,12 @@ class controlvalue
       return m_floatval;
     }
 
+    //value written by the ladspa plugin to a control output port
+    float FloatOut()
+    {
+      return m_floatout;
+    }
+
     void SetSmooth(bool smooth)
     {
       m_smooth = smooth;
@@ -145,13 +151,23 @@ class CPort
     void          AllocateBuffer(int buffersize);
     float*        GetBuffer(float* jackptr);
     jack_port_t*  GetJackPort()   { return m_jackport;   }
+    void          SetJackBuffer(float* buf) { m_jackbuf = buf; }
+    float*        GetJackBuffer()           { return m_jackbuf; }
     bool          IsInput()       { return m_isinput;    }
     unsigned long GetLadspaPort() { return m_ladspaport; }
 
+    void          SetBypassPort(int port)   { m_bypassport = port; }
+    int           GetBypassPort()           { return m_bypassport; }
+    void          SetRunBuffer(float* buf)  { m_runbuf = buf;      }
+    float*        GetRunBuffer()            { return m_runbuf;     }
+
   private:
     jack_port_t*  m_jackport;
     unsigned long m_ladspaport;
     float*        m_buf;
+    float*        m_jackbuf;   //the jack buffer of the current period
+    float*        m_runbuf;    //the buffer connected to the ladspa port in the current run
+    int           m_bypassport; //index of the input port that's copied to this output port when bypassed
     bool          m_isinput;
 };
 
@@ -167,7 +183,12 @@ class CLadspaInstance
     void Activate();
     void Deactivate();
     void AllocateBuffers(int buffersize);
-    void Run(jack_nframes_t jackframes, int frames, int offset, float pregain, float postgain);
+    void WarmUp(int samples);
+    void SetBypass(bool bypass) { m_bypass = bypass; }
+    void SetFreewheel(bool freewheel);
+    void GetJackBuffers(jack_nframes_t jackframes);
+    void Run(int frames, int offset, float pregain, float postgain);
+    void GetControlOutputs(std::vector<float>& values);
 
   private:
     std::string        m_name;
@@ -182,6 +203,10 @@ class CLadspaInstance
     LADSPA_Handle      m_handle;
     std::vector<CPort> m_ports;
     bool               m_activated;
+    bool               m_bypass;
+    bool               m_freewheel;
+    int                m_rtpriority; //realtime priority of the jack thread
+    float              m_bypassgain; //0.0 when the plugin output is used, 1.0 when fully bypassed
 };
 
 #endif //LADSPAINSTANCE_H
@@ -26,10 +26,15 @@ using namespace std;
 
 CLadspaPlugin::CLadspaPlugin(const std::string& filename, void* handle, const LADSPA_Descriptor* descriptor)
 {
-  m_filename    = filename;
-  m_handle      = handle;
-  m_descriptor  = descriptor;
-  m_fullyloaded = false;
+  m_filename        = filename;
+  m_handle          = handle;
+  m_descriptor      = descriptor;
+  m_fullyloaded     = false;
+  m_isidentity      = NULL;
+  m_skipped         = NULL;
+  m_waitloaded      = NULL;
+  m_setrtpriority   = NULL;
+  m_smoothscontrols = NULL;
 }
 
 CLadspaPlugin::~CLadspaPlugin()
@@ -73,6 +78,13 @@ void CLadspaPlugin::LoadAllSymbols()
   {
     LogError("Unable to open new handle for %s: %s", m_filename.c_str(), dlerror());
   }
+
+  //look up the bobdsp extensions, these are only in bobdsp.so
+  m_isidentity = (BobDSP_Is_Identity_Function)dlsym(m_handle, BOBDSP_IS_IDENTITY);
+  m_skipped = (BobDSP_Skipped_Function)dlsym(m_handle, BOBDSP_SKIPPED);
+  m_waitloaded = (BobDSP_Wait_Loaded_Function)dlsym(m_handle, BOBDSP_WAIT_LOADED);
+  m_setrtpriority = (BobDSP_Set_RT_Priority_Function)dlsym(m_handle, BOBDSP_SET_RT_PRIORITY);
+  m_smoothscontrols = (BobDSP_Smooths_Controls_Function)dlsym(m_handle, BOBDSP_SMOOTHS_CONTROLS);
 }
 
 int CLadspaPlugin::AudioInputPorts()
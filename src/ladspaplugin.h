@@ -21,6 +21,7 @@
 
 #include <string>
 #include <ladspa.h>
+#include "ladspa/extensions.h"
 
 class CLadspaPlugin
 {
@@ -67,6 +68,17 @@ class CLadspaPlugin
     bool                        HasDefault(unsigned long port);
     float                       DefaultValue(unsigned long port, int samplerate);
 
+    bool IsIdentity(LADSPA_Handle handle) { return m_isidentity && m_isidentity(handle) != 0; }
+    void Skipped(LADSPA_Handle handle)    { if (m_skipped) m_skipped(handle); }
+    void WaitLoaded(LADSPA_Handle handle) { if (m_waitloaded) m_waitloaded(handle); }
+    void SetRealtimePriority(LADSPA_Handle handle, int priority)
+    {
+      if (m_setrtpriority)
+        m_setrtpriority(handle, priority);
+    }
+
+    bool SmoothsControls() { return m_smoothscontrols && m_smoothscontrols(m_descriptor) != 0; }
+
     int AudioInputPorts();
     int AudioOutputPorts();
     int ControlInputPorts();
@@ -75,10 +87,15 @@ class CLadspaPlugin
   private:
     float MakeDefault(bool islog, float low, float high, float interpolate);
 
-    const LADSPA_Descriptor* m_descriptor;
-    std::string              m_filename;
-    void*                    m_handle;
-    bool                     m_fullyloaded;
+    const LADSPA_Descriptor*         m_descriptor;
+    std::string                      m_filename;
+    void*                            m_handle;
+    BobDSP_Is_Identity_Function      m_isidentity;
+    BobDSP_Skipped_Function          m_skipped;
+    BobDSP_Wait_Loaded_Function      m_waitloaded;
+    BobDSP_Set_RT_Priority_Function  m_setrtpriority;
+    BobDSP_Smooths_Controls_Function m_smoothscontrols;
+    bool                             m_fullyloaded;
 };
 
 #endif //LADSPAPLUGIN_H
@@ -120,6 +120,26 @@ void OPTIMIZE CopyApplyGain(float* in, float* out, int samples, float gain)
     *(outptr++) = *(inptr++) * gain;
 }
 
+//mixes in into out, with the gain for in starting at gain and increasing with step each sample
+//the gain for out is 1.0 - the gain for in, if in is NULL, out is faded to silence
+//the gcc vectorizer can handle this
+void OPTIMIZE CrossFade(float* in, float* out, int samples, float gain, float step)
+{
+  if (in)
+  {
+    for (int i = 0; i < samples; i++)
+    {
+      float ingain = gain + step * i;
+      out[i] = out[i] * (1.0f - ingain) + in[i] * ingain;
+    }
+  }
+  else
+  {
+    for (int i = 0; i < samples; i++)
+      out[i] *= 1.0f - (gain + step * i);
+  }
+}
+
 void OPTIMIZE DenormalsToZero(float* data, int samples)
 {
   float* dataptr = data;
@@ -22,6 +22,7 @@ namespace UTILNAMESPACE
 {
   void ApplyGain(float* data, int samples, float gain);
   void CopyApplyGain(float* in, float* out, int samples, float gain);
+  void CrossFade(float* in, float* out, int samples, float gain, float step);
   void DenormalsToZero(float* data, int samples);
   void AvgSquare(float* data, int samples, float& avg);
   void AvgAbs(float* data, int samples, float& avg);
@@ -0,0 +1,443 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#ifdef RTCHECK
+
+#ifndef _GNU_SOURCE
+  #define _GNU_SOURCE //for RTLD_NEXT
+#endif //_GNU_SOURCE
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <errno.h>
+#include <malloc.h>
+#include <poll.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <time.h>
+#include <unistd.h>
+#include <set>
+#include <string>
+
+#include "util/inclstdint.h"
+#include "util/rtcheck.h"
+#include "util/log.h"
+#include "util/JSON.h"
+
+using namespace std;
+
+//the real memory allocation functions from glibc, these are used instead of dlsym()
+//because dlsym() itself might allocate memory
+extern "C"
+{
+  void* __libc_malloc(size_t size);
+  void* __libc_calloc(size_t nmemb, size_t size);
+  void* __libc_realloc(void* ptr, size_t size);
+  void  __libc_free(void* ptr);
+  void* __libc_memalign(size_t alignment, size_t size);
+}
+
+enum RTCALL
+{
+  RTCallMalloc,
+  RTCallCalloc,
+  RTCallRealloc,
+  RTCallFree,
+  RTCallMemalign,
+  RTCallMmap,
+  RTCallMunmap,
+  RTCallMutexLock,
+  RTCallCondWait,
+  RTCallJoin,
+  RTCallSemWait,
+  RTCallSleep,
+  RTCallRead,
+  RTCallWrite,
+  RTCallPoll,
+  RTCallMax,
+};
+
+static const char* g_rtcallnames[] =
+{
+  "malloc",
+  "calloc",
+  "realloc",
+  "free",
+  "memalign",
+  "mmap",
+  "munmap",
+  "pthread_mutex_lock",
+  "pthread_cond_wait",
+  "pthread_join",
+  "sem_wait",
+  "sleep",
+  "read",
+  "write",
+  "poll",
+};
+
+#define MAXFRAMES  32
+#define RINGSIZE   256
+
+struct rtviolation
+{
+  volatile bool ready;
+  RTCALL        call;
+  char          threadname[16];
+  int           nrframes;
+  void*         frames[MAXFRAMES];
+};
+
+//these are only touched by the thread itself, so the check doesn't need any synchronization
+static __thread bool g_inrealtime;
+static __thread bool g_inviolation;
+static __thread char g_threadname[16];
+
+//violations are counted with atomic adds, and queued in a ring buffer that's read from the main thread
+static volatile int64_t   g_counters[RTCallMax];
+static volatile int64_t   g_dropped;
+static volatile uint32_t  g_writepos;
+static volatile uint32_t  g_readpos;
+static rtviolation        g_violations[RINGSIZE];
+
+//hashes of the backtraces that have been logged, only used from RTCheckReport()
+static set<uint64_t>*     g_loggedtraces;
+
+//the next definitions of the intercepted functions, looked up with dlsym() in RTCheckInit(),
+//since dlsym() might allocate memory, which shouldn't happen in realtime code
+#define REALFUNC(name) static __typeof__(&name) real##name;
+REALFUNC(mmap)
+REALFUNC(munmap)
+REALFUNC(pthread_mutex_lock)
+REALFUNC(pthread_cond_wait)
+REALFUNC(pthread_cond_timedwait)
+REALFUNC(pthread_join)
+REALFUNC(sem_wait)
+REALFUNC(nanosleep)
+REALFUNC(usleep)
+REALFUNC(read)
+REALFUNC(write)
+REALFUNC(poll)
+REALFUNC(select)
+
+#define LOOKUPREAL(name) \
+  if (!real##name) \
+    real##name = (__typeof__(&name))dlsym(RTLD_NEXT, #name);
+
+static void LookupRealFunctions()
+{
+  LOOKUPREAL(mmap)
+  LOOKUPREAL(munmap)
+  LOOKUPREAL(pthread_mutex_lock)
+  LOOKUPREAL(pthread_cond_wait)
+  LOOKUPREAL(pthread_cond_timedwait)
+  LOOKUPREAL(pthread_join)
+  LOOKUPREAL(sem_wait)
+  LOOKUPREAL(nanosleep)
+  LOOKUPREAL(usleep)
+  LOOKUPREAL(read)
+  LOOKUPREAL(write)
+  LOOKUPREAL(poll)
+  LOOKUPREAL(select)
+}
+
+static void __attribute__((constructor)) RTCheckInit()
+{
+  LookupRealFunctions();
+
+  //backtrace() loads libgcc_s on its first call, which allocates memory
+  //so call it once here, before any realtime code runs
+  void* frames[1];
+  backtrace(frames, 1);
+}
+
+static void Violation(RTCALL call)
+{
+  //don't count calls made while handling a violation, backtrace() might call any of the intercepted functions
+  if (!g_inrealtime || g_inviolation)
+    return;
+
+  g_inviolation = true;
+
+  __sync_fetch_and_add(g_counters + call, 1);
+
+  //claim a slot in the ring buffer, if it's full, the violation is only counted
+  uint32_t writepos;
+  for(;;)
+  {
+    writepos = g_writepos;
+    if (writepos - g_readpos >= RINGSIZE)
+    {
+      __sync_fetch_and_add(&g_dropped, 1);
+      g_inviolation = false;
+      return;
+    }
+
+    if (__sync_bool_compare_and_swap(&g_writepos, writepos, writepos + 1))
+      break;
+  }
+
+  rtviolation& violation = g_violations[writepos % RINGSIZE];
+  violation.call = call;
+  memcpy(violation.threadname, g_threadname, sizeof(violation.threadname));
+  violation.nrframes = backtrace(violation.frames, MAXFRAMES);
+
+  __sync_synchronize();
+  violation.ready = true;
+
+  g_inviolation = false;
+}
+
+void RTCheckSetThreadName(const char* name)
+{
+  strncpy(g_threadname, name, sizeof(g_threadname) - 1);
+}
+
+void RTCheckEnter()
+{
+  g_inrealtime = true;
+}
+
+void RTCheckLeave()
+{
+  g_inrealtime = false;
+}
+
+void RTCheckReport()
+{
+  if (!g_loggedtraces)
+    g_loggedtraces = new set<uint64_t>;
+
+  while (g_readpos != g_writepos)
+  {
+    rtviolation& violation = g_violations[g_readpos % RINGSIZE];
+    if (!violation.ready)
+      break; //the realtime thread is still writing the backtrace
+
+    __sync_synchronize();
+
+    //only log each unique backtrace once, a plugin that allocates on every run
+    //would otherwise flood the log
+    uint64_t hash = violation.call;
+    for (int i = 0; i < violation.nrframes; i++)
+      hash = hash * 31 + (uintptr_t)violation.frames[i];
+
+    if (g_loggedtraces->insert(hash).second)
+    {
+      LogError("Realtime violation: %s called from thread \"%s\"",
+               g_rtcallnames[violation.call], violation.threadname);
+
+      char** symbols = backtrace_symbols(violation.frames, violation.nrframes);
+      if (symbols)
+      {
+        //skip the first frame, it's Violation() itself
+        for (int i = 1; i < violation.nrframes; i++)
+          LogError("  #%i %s", i, symbols[i]);
+
+        free(symbols);
+      }
+    }
+
+    violation.ready = false;
+    __sync_synchronize();
+    g_readpos++;
+  }
+}
+
+CJSONGenerator* RTCheckToJSON()
+{
+  CJSONGenerator* generator = new CJSONGenerator(true);
+  generator->MapOpen();
+
+  int64_t total = 0;
+  for (int i = 0; i < RTCallMax; i++)
+  {
+    generator->AddString(g_rtcallnames[i]);
+    generator->AddInt(g_counters[i]);
+    total += g_counters[i];
+  }
+
+  generator->AddString("total");
+  generator->AddInt(total);
+  generator->AddString("dropped");
+  generator->AddInt(g_dropped);
+
+  generator->MapClose();
+
+  return generator;
+}
+
+//the intercepted functions can be called from constructors of other libraries
+//before RTCheckInit() has run, look up the real functions there when needed
+#define CHECKREAL(name) \
+  if (!real##name) \
+    LookupRealFunctions();
+
+extern "C"
+{
+
+void* malloc(size_t size) __THROW
+{
+  Violation(RTCallMalloc);
+  return __libc_malloc(size);
+}
+
+void* calloc(size_t nmemb, size_t size) __THROW
+{
+  Violation(RTCallCalloc);
+  return __libc_calloc(nmemb, size);
+}
+
+void* realloc(void* ptr, size_t size) __THROW
+{
+  Violation(RTCallRealloc);
+  return __libc_realloc(ptr, size);
+}
+
+void free(void* ptr) __THROW
+{
+  Violation(RTCallFree);
+  __libc_free(ptr);
+}
+
+void* memalign(size_t alignment, size_t size) __THROW
+{
+  Violation(RTCallMemalign);
+  return __libc_memalign(alignment, size);
+}
+
+void* aligned_alloc(size_t alignment, size_t size) __THROW
+{
+  Violation(RTCallMemalign);
+  return __libc_memalign(alignment, size);
+}
+
+int posix_memalign(void** memptr, size_t alignment, size_t size) __THROW
+{
+  Violation(RTCallMemalign);
+
+  if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0)
+    return EINVAL;
+
+  void* ptr = __libc_memalign(alignment, size);
+  if (!ptr)
+    return ENOMEM;
+
+  *memptr = ptr;
+  return 0;
+}
+
+void* mmap(void* addr, size_t length, int prot, int flags, int fd, off_t offset) __THROW
+{
+  Violation(RTCallMmap);
+  CHECKREAL(mmap);
+  return realmmap(addr, length, prot, flags, fd, offset);
+}
+
+int munmap(void* addr, size_t length) __THROW
+{
+  Violation(RTCallMunmap);
+  CHECKREAL(munmap);
+  return realmunmap(addr, length);
+}
+
+int pthread_mutex_lock(pthread_mutex_t* mutex) __THROWNL
+{
+  Violation(RTCallMutexLock);
+  CHECKREAL(pthread_mutex_lock);
+  return realpthread_mutex_lock(mutex);
+}
+
+int pthread_cond_wait(pthread_cond_t* cond, pthread_mutex_t* mutex)
+{
+  Violation(RTCallCondWait);
+  CHECKREAL(pthread_cond_wait);
+  return realpthread_cond_wait(cond, mutex);
+}
+
+int pthread_cond_timedwait(pthread_cond_t* cond, pthread_mutex_t* mutex, const struct timespec* abstime)
+{
+  Violation(RTCallCondWait);
+  CHECKREAL(pthread_cond_timedwait);
+  return realpthread_cond_timedwait(cond, mutex, abstime);
+}
+
+int pthread_join(pthread_t thread, void** retval)
+{
+  Violation(RTCallJoin);
+  CHECKREAL(pthread_join);
+  return realpthread_join(thread, retval);
+}
+
+int sem_wait(sem_t* sem)
+{
+  Violation(RTCallSemWait);
+  CHECKREAL(sem_wait);
+  return realsem_wait(sem);
+}
+
+int nanosleep(const struct timespec* req, struct timespec* rem)
+{
+  Violation(RTCallSleep);
+  CHECKREAL(nanosleep);
+  return realnanosleep(req, rem);
+}
+
+int usleep(useconds_t usec)
+{
+  Violation(RTCallSleep);
+  CHECKREAL(usleep);
+  return realusleep(usec);
+}
+
+ssize_t read(int fd, void* buf, size_t count)
+{
+  Violation(RTCallRead);
+  CHECKREAL(read);
+  return realread(fd, buf, count);
+}
+
+ssize_t write(int fd, const void* buf, size_t count)
+{
+  Violation(RTCallWrite);
+  CHECKREAL(write);
+  return realwrite(fd, buf, count);
+}
+
+int poll(struct pollfd* fds, nfds_t nfds, int timeout)
+{
+  Violation(RTCallPoll);
+  CHECKREAL(poll);
+  return realpoll(fds, nfds, timeout);
+}
+
+int select(int nfds, fd_set* readfds, fd_set* writefds, fd_set* exceptfds, struct timeval* timeout)
+{
+  Violation(RTCallPoll);
+  CHECKREAL(select);
+  return realselect(nfds, readfds, writefds, exceptfds, timeout);
+}
+
+}
+
+#endif //RTCHECK
@@ -0,0 +1,52 @@
+/*
+ * bobdsp
+ * Copyright (C) Bob 2026
+ * 
+ * bobdsp is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License as published by the
+ * Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * bobdsp is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License along
+ * with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef RTCHECK_H
+#define RTCHECK_H
+
+#include "config.h"
+
+//when bobdsp is configured with --rtcheck, calls to functions that might block,
+//like memory allocation, mutex locks and blocking syscalls, are intercepted
+//when they're made from realtime code, each of these calls is counted and logged
+//with a backtrace from the main thread, a thread only runs realtime code between
+//RTCheckEnter() and RTCheckLeave(), so that blocking outside of that, like libjack waiting
+//for the next cycle, isn't counted
+
+#define RTCHECKINTERVAL 1000000 //how often the main loop logs new violations, in microseconds
+
+class CJSONGenerator;
+
+#ifdef RTCHECK
+
+void            RTCheckSetThreadName(const char* name);
+void            RTCheckEnter();
+void            RTCheckLeave();
+void            RTCheckReport();
+CJSONGenerator* RTCheckToJSON();
+
+#else
+
+inline void     RTCheckSetThreadName(const char* name) {}
+inline void     RTCheckEnter() {}
+inline void     RTCheckLeave() {}
+inline void     RTCheckReport() {}
+
+#endif //RTCHECK
+
+#endif //RTCHECK_H